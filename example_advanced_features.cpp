@@ -78,8 +78,7 @@ int main()
     // Test 1: Buffer mapping
     printf("\n--- Test 1: Buffer Mapping ---\n");
     rcompute_set_uniform_float(&ctx, "multiplier", 2.0f);
-    rcompute_dispatch_1d(&ctx, N);
-    rcompute_barrier_all();
+    rcompute_dispatch_items_1d(&ctx, N);
 
     float *mapped = (float *)rcompute_buffer_map(buffer, GL_READ_ONLY);
     if (mapped)
@@ -92,7 +91,7 @@ int main()
     // Test 2: Async read
     printf("\n--- Test 2: Async Buffer Read ---\n");
     rcompute_set_uniform_float(&ctx, "multiplier", 0.5f);
-    rcompute_dispatch_1d(&ctx, N);
+    rcompute_dispatch_items_1d(&ctx, N);
     
     float *async_data = new float[10];
     rcompute_read_async(buffer, async_data, 10 * sizeof(float), 0);
@@ -111,12 +110,11 @@ int main()
     ctx.program = rcompute_compile(shader_v2);
     if (ctx.program)
     {
-        glDeleteProgram(old_program);
+        rcompute_program_destroy(old_program);
         printf("Shader reloaded successfully!\n");
         
         rcompute_set_uniform_float(&ctx, "multiplier", 2.0f);
-        rcompute_dispatch_1d(&ctx, N);
-        rcompute_barrier_all();
+        rcompute_dispatch_items_1d(&ctx, N);
         
         rcompute_read_async(buffer, async_data, 10 * sizeof(float), 0);
         rcompute_wait_async();
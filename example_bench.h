@@ -0,0 +1,427 @@
+// example_bench.h - shared benchmark mode for the examples and rcompute_bench
+//
+// Every example that times GPU work goes through bench_time(). Run normally, each timed section
+// executes once, exactly as before. With --bench it runs warmup repetitions and then timed ones,
+// and the min/median/p95/max/mean of every section are printed and written to a results file.
+// Given a baseline results file, bench_finish() compares medians and fails when a section got
+// slower by more than the threshold and also fell outside the baseline's own spread (past its p95,
+// or below its min for higher-is-better units), so a CI job can run:
+//
+//   ./example_blur --bench --results blur.json                        # record
+//   ./example_blur --bench --baseline blur.json --threshold 10        # exit 1 on a >10% slowdown
+//
+// Options: --bench, --warmup N (3), --runs N (10), --quick (1 warmup, 5 runs), --seed N (12345),
+//          --size N (problem size, meaning is per example), --results path (<name>.json in bench
+//          mode), --baseline path, --threshold percent (10)
+//
+// The statistics are wall-clock around glFinish, like rcompute_bench, so they do not depend on
+// timer query support. The value bench_time() returns, which the examples print, is still the
+// GPU time from a timer query, as it was before the harness, except where the query reads next
+// to nothing (llvmpipe reports 1 ns): then it is the wall-clock time. Include after rcompute.h in
+// a single translation unit.
+
+#ifndef EXAMPLE_BENCH_H
+#define EXAMPLE_BENCH_H
+
+#include "include/rcompute.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+struct bench_result
+{
+    std::string name;
+    const char *unit;
+    int higher_is_better;
+    int samples;
+    double min, median, p95, max, mean;
+};
+
+static struct
+{
+    const char *name;
+    int enabled;
+    int quick;
+    int warmup, runs;
+    unsigned int seed;
+    int size; // 0 when --size was not given
+    const char *results_path;
+    const char *baseline_path;
+    double threshold; // percent
+    std::string renderer, vendor, version;
+    std::vector<bench_result> results;
+} bench;
+
+// ---------------------------------
+// Options
+// ---------------------------------
+static inline void bench__usage(const char *argv0)
+{
+    fprintf(stderr,
+            "Usage: %s [--bench] [--warmup N] [--runs N] [--quick] [--seed N] [--size N]\n"
+            "       [--results path] [--baseline path] [--threshold percent]\n",
+            argv0);
+}
+
+// Parses the shared options and seeds rand(). enabled forces benchmark mode (rcompute_bench).
+// Returns 0 after printing usage on an unknown or malformed option.
+static inline int bench_init(int argc, char **argv, const char *name, int enabled = 0)
+{
+    bench.name = name;
+    bench.enabled = enabled;
+    bench.quick = 0;
+    bench.warmup = -1;
+    bench.runs = -1;
+    bench.seed = 12345u;
+    bench.size = 0;
+    bench.results_path = NULL;
+    bench.baseline_path = NULL;
+    bench.threshold = 10.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--bench") == 0)
+            bench.enabled = 1;
+        else if (strcmp(arg, "--quick") == 0)
+        {
+            bench.quick = 1;
+            bench.warmup = 1;
+            bench.runs = 5;
+        }
+        else if (!value)
+        {
+            bench__usage(argv[0]);
+            return 0;
+        }
+        else if (strcmp(arg, "--warmup") == 0)
+            bench.warmup = atoi(argv[++i]);
+        else if (strcmp(arg, "--runs") == 0)
+            bench.runs = atoi(argv[++i]);
+        else if (strcmp(arg, "--seed") == 0)
+            bench.seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(arg, "--size") == 0)
+            bench.size = atoi(argv[++i]);
+        else if (strcmp(arg, "--results") == 0)
+            bench.results_path = argv[++i];
+        else if (strcmp(arg, "--baseline") == 0)
+            bench.baseline_path = argv[++i];
+        else if (strcmp(arg, "--threshold") == 0)
+            bench.threshold = atof(argv[++i]);
+        else
+        {
+            bench__usage(argv[0]);
+            return 0;
+        }
+    }
+
+    // outside benchmark mode a timed section runs once, unless --warmup/--runs ask otherwise
+    if (bench.warmup < 0)
+        bench.warmup = bench.enabled ? 3 : 0;
+    if (bench.runs < 0)
+        bench.runs = bench.enabled ? 10 : 1;
+    if (bench.runs < 1 || bench.size < 0 || bench.threshold < 0.0)
+    {
+        fprintf(stderr, "--runs must be at least 1; --size and --threshold must not be negative\n");
+        return 0;
+    }
+
+    static std::string default_results;
+    if (bench.enabled && !bench.results_path)
+    {
+        default_results = std::string(name) + ".json";
+        bench.results_path = default_results.c_str();
+    }
+
+    srand(bench.seed);
+    return 1;
+}
+
+static inline int bench_enabled()
+{
+    return bench.enabled;
+}
+
+static inline unsigned int bench_seed()
+{
+    return bench.seed;
+}
+
+static inline int bench_size(int default_size)
+{
+    return bench.size > 0 ? bench.size : default_size;
+}
+
+// ---------------------------------
+// Measurement
+// ---------------------------------
+static inline double bench_now_ms()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+static inline int bench__compare(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+// linear interpolation between the two nearest ranks; values must be sorted
+static inline double bench_percentile(const double *values, int count, double p)
+{
+    double rank = p / 100.0 * (count - 1);
+    int lo = (int)rank;
+    int hi = lo + 1 < count ? lo + 1 : lo;
+    return values[lo] + (values[hi] - values[lo]) * (rank - lo);
+}
+
+// Adds a result from count per-run values (sorted in place). count <= 0 records nothing and, in
+// benchmark mode, reports the section as skipped. Returns the median, or 0 when skipped.
+static inline double bench_record(const char *name, const char *unit, double *values, int count, int higher_is_better = 0)
+{
+    // the context may be gone by bench_finish, so capture the device on first use
+    if (bench.renderer.empty())
+    {
+        const char *renderer = (const char *)glGetString(GL_RENDERER);
+        const char *vendor = (const char *)glGetString(GL_VENDOR);
+        const char *version = (const char *)glGetString(GL_VERSION);
+        bench.renderer = renderer ? renderer : "unknown";
+        bench.vendor = vendor ? vendor : "unknown";
+        bench.version = version ? version : "unknown";
+    }
+
+    if (count <= 0)
+    {
+        if (bench.enabled)
+            printf("[bench] %s skipped\n", name);
+        return 0.0;
+    }
+
+    qsort(values, count, sizeof(double), bench__compare);
+    bench_result r;
+    r.name = name;
+    r.unit = unit;
+    r.higher_is_better = higher_is_better;
+    r.samples = count;
+    r.min = values[0];
+    r.median = bench_percentile(values, count, 50.0);
+    r.p95 = bench_percentile(values, count, 95.0);
+    r.max = values[count - 1];
+    r.mean = 0.0;
+    for (int i = 0; i < count; i++)
+        r.mean += values[i];
+    r.mean /= count;
+    bench.results.push_back(r);
+    return r.median;
+}
+
+// Wall-clock milliseconds of one call to op, with the GPU idle before and after. gpu_ms, if
+// given, receives the GPU time of op from rcompute_timer_begin/end, or the wall-clock time when
+// the query reads under a thousandth of it and so was not really measured.
+template <typename Op>
+static inline double bench_once(Op op, double *gpu_ms = NULL)
+{
+    glFinish();
+    double t0 = bench_now_ms();
+    rcompute_timer_begin();
+    op();
+    double gpu = rcompute_timer_end();
+    glFinish();
+    double ms = bench_now_ms() - t0;
+    if (gpu_ms)
+        *gpu_ms = gpu * 1000.0 > ms ? gpu : ms;
+    return ms;
+}
+
+// amount per second over ms milliseconds; 0 when no time was measured
+static inline double bench_per_second(double amount, double ms)
+{
+    return ms > 0.0 ? amount * 1000.0 / ms : 0.0;
+}
+
+// Runs op warmup + runs times and records the wall-clock statistics of the section. Returns the
+// median GPU time in milliseconds, which is the single timer-query result outside benchmark mode.
+// reset runs untimed before every repetition, so kernels that accumulate (atomics, blending) can
+// start from the same state each time.
+template <typename Op, typename Reset>
+static inline double bench_time(const char *name, Op op, Reset reset)
+{
+    std::vector<double> values, gpu_values;
+    for (int i = 0; i < bench.warmup + bench.runs; i++)
+    {
+        reset();
+        double gpu_ms;
+        double ms = bench_once(op, &gpu_ms);
+        if (i >= bench.warmup)
+        {
+            values.push_back(ms);
+            gpu_values.push_back(gpu_ms);
+        }
+    }
+    bench_record(name, "ms", values.data(), (int)values.size());
+    qsort(gpu_values.data(), gpu_values.size(), sizeof(double), bench__compare);
+    return bench_percentile(gpu_values.data(), (int)gpu_values.size(), 50.0);
+}
+
+template <typename Op>
+static inline double bench_time(const char *name, Op op)
+{
+    return bench_time(name, op, []() {});
+}
+
+// ---------------------------------
+// Results and baseline comparison
+// ---------------------------------
+static inline void bench__print_table()
+{
+    printf("\n[bench] %s: %d warmup + %d timed runs, seed %u\n", bench.name, bench.warmup, bench.runs, bench.seed);
+    printf("  %-24s %10s %10s %10s %10s %10s\n", "section", "min", "median", "p95", "max", "mean");
+    for (const bench_result &r : bench.results)
+        printf("  %-24s %10.3f %10.3f %10.3f %10.3f %10.3f  %s\n", r.name.c_str(), r.min, r.median, r.p95, r.max,
+               r.mean, r.unit);
+}
+
+// JSON string literal for s, quotes included
+static inline std::string bench__json_string(const char *s)
+{
+    std::string out = "\"";
+    for (; *s; s++)
+    {
+        unsigned char ch = (unsigned char)*s;
+        if (ch == '"' || ch == '\\')
+        {
+            out += '\\';
+            out += (char)ch;
+        }
+        else if (ch < 0x20)
+        {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", ch);
+            out += esc;
+        }
+        else
+            out += (char)ch;
+    }
+    return out + "\"";
+}
+
+static inline void bench__write_results()
+{
+    FILE *f = fopen(bench.results_path, "w");
+    if (!f)
+    {
+        fprintf(stderr, "[bench] cannot write %s\n", bench.results_path);
+        return;
+    }
+    fprintf(f,
+            "{\n  \"program\": %s,\n  \"renderer\": %s,\n  \"vendor\": %s,\n  \"version\": %s,\n"
+            "  \"seed\": %u,\n  \"size\": %d,\n  \"warmup\": %d,\n  \"runs\": %d,\n  \"results\": [",
+            bench__json_string(bench.name).c_str(), bench__json_string(bench.renderer.c_str()).c_str(),
+            bench__json_string(bench.vendor.c_str()).c_str(), bench__json_string(bench.version.c_str()).c_str(),
+            bench.seed, bench.size, bench.warmup, bench.runs);
+    for (size_t i = 0; i < bench.results.size(); i++)
+    {
+        const bench_result &r = bench.results[i];
+        fprintf(f,
+                "%s\n    {\"name\": %s, \"unit\": %s, \"better\": \"%s\", \"samples\": %d, \"min\": %.6g, "
+                "\"median\": %.6g, \"p95\": %.6g, \"max\": %.6g, \"mean\": %.6g}",
+                i ? "," : "", bench__json_string(r.name.c_str()).c_str(), bench__json_string(r.unit).c_str(),
+                r.higher_is_better ? "higher" : "lower", r.samples, r.min,
+                r.median, r.p95, r.max, r.mean);
+    }
+    fprintf(f, "\n  ]\n}\n");
+    fclose(f);
+    printf("[bench] results written to %s\n", bench.results_path);
+}
+
+// Finds a statistic ("median", "p95", ...) recorded for name in a results file written by
+// bench__write_results.
+static inline int bench__baseline_value(const std::string &text, const std::string &name, const char *stat,
+                                        double *value)
+{
+    std::string key = "\"name\": " + bench__json_string(name.c_str());
+    size_t at = text.find(key);
+    if (at == std::string::npos)
+        return 0;
+    size_t end = text.find('}', at + key.size());
+    std::string field_key = std::string("\"") + stat + "\": ";
+    size_t field = text.find(field_key, at);
+    if (field == std::string::npos || field > end)
+        return 0;
+    *value = strtod(text.c_str() + field + field_key.size(), NULL);
+    return 1;
+}
+
+// Returns the number of sections that regressed, or -1 without a baseline. A regression must pass
+// the threshold and also land outside the baseline's spread, so run-to-run noise isn't flagged.
+static inline int bench__compare_baseline()
+{
+    FILE *f = fopen(bench.baseline_path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "[bench] cannot read baseline %s\n", bench.baseline_path);
+        return -1;
+    }
+    std::string text;
+    char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+        text.append(chunk, n);
+    fclose(f);
+
+    printf("\n[bench] median vs baseline %s (fail above +%.1f%% slower)\n", bench.baseline_path, bench.threshold);
+    int regressions = 0;
+    for (const bench_result &r : bench.results)
+    {
+        double base;
+        if (!bench__baseline_value(text, r.name, "median", &base))
+        {
+            printf("  %-24s %10s -> %10.3f %-5s  new\n", r.name.c_str(), "-", r.median, r.unit);
+            continue;
+        }
+        if (base <= 0.0 || r.median <= 0.0)
+        {
+            printf("  %-24s %10.3f -> %10.3f %-5s  not comparable\n", r.name.c_str(), base, r.median, r.unit);
+            continue;
+        }
+
+        // positive means slower, whichever direction the unit improves in
+        double slowdown = r.higher_is_better ? (base / r.median - 1.0) * 100.0 : (r.median / base - 1.0) * 100.0;
+
+        // the worst run the baseline itself saw; files without it only get the threshold
+        double bound;
+        int noisy = 0;
+        if (bench__baseline_value(text, r.name, r.higher_is_better ? "min" : "p95", &bound))
+            noisy = r.higher_is_better ? r.median >= bound : r.median <= bound;
+
+        int regressed = slowdown > bench.threshold && !noisy;
+        regressions += regressed;
+        printf("  %-24s %10.3f -> %10.3f %-5s %+7.1f%%  %s\n", r.name.c_str(), base, r.median, r.unit, slowdown,
+               regressed ? "REGRESSION" : slowdown > bench.threshold ? "ok (within baseline spread)" : "ok");
+    }
+    return regressions;
+}
+
+// Prints and writes the results, then compares against the baseline if one was given.
+// Returns the process exit status: 1 when any section regressed, otherwise 0.
+static inline int bench_finish()
+{
+    if (bench.enabled)
+        bench__print_table();
+    if (bench.results_path)
+        bench__write_results();
+    if (!bench.baseline_path)
+        return 0;
+
+    int regressions = bench__compare_baseline();
+    if (regressions > 0)
+        printf("[bench] %d section%s regressed\n", regressions, regressions == 1 ? "" : "s");
+    return regressions ? 1 : 0;
+}
+
+#endif // EXAMPLE_BENCH_H
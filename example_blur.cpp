@@ -3,6 +3,7 @@
 
 #define RCOMPUTE_IMPLEMENTATION
 #include "include/rcompute.h"
+#include "example_bench.h"
 #include <stdio.h>
 #include <math.h>
 
@@ -37,12 +38,15 @@ void generate_test_pattern(float *data, int width, int height)
     }
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    if (!bench_init(argc, argv, "example_blur"))
+        return 1;
+    
     printf("=== Separable Gaussian Blur ===\n\n");
     
-    const int WIDTH = 1024;
-    const int HEIGHT = 1024;
+    const int WIDTH = bench_size(1024);  // --size sets the image edge
+    const int HEIGHT = WIDTH;
     
     rcompute ctx;
     if (!rcompute_init(&ctx, 4, 3)) {
@@ -62,9 +66,11 @@ int main()
     generate_test_pattern(input_data, WIDTH, HEIGHT);
     write_ppm("blur_input.ppm", input_data, WIDTH, HEIGHT);
     
-    // Create textures (need 3: input, temp, output)
+    // Create textures (need 3: input, temp, output); the temp one is scratch from a transient arena
+    rcompute_arena *arena = rcompute_arena_create(0);
+    rcompute_arena_begin(arena);
     GLuint tex_input = rcompute_texture_2d(WIDTH, HEIGHT, GL_RGBA32F, input_data);
-    GLuint tex_temp = rcompute_texture_2d(WIDTH, HEIGHT, GL_RGBA32F, NULL);
+    GLuint tex_temp = rcompute_arena_texture_2d(arena, WIDTH, HEIGHT, GL_RGBA32F);
     GLuint tex_output = rcompute_texture_2d(WIDTH, HEIGHT, GL_RGBA32F, NULL);
     
     // Gaussian weights for sigma=2.0
@@ -75,17 +81,11 @@ int main()
     rcompute_texture_bind(tex_input, 0, GL_RGBA32F);
     rcompute_texture_bind(tex_temp, 1, GL_RGBA32F);
     rcompute_set_uniform_int(&ctx, "horizontal", 1);
+    rcompute_set_uniform_float_array(&ctx, "weights", weights, 5);
     
-    for (int i = 0; i < 5; i++) {
-        char name[32];
-        snprintf(name, sizeof(name), "weights[%d]", i);
-        rcompute_set_uniform_float(&ctx, name, weights[i]);
-    }
-    
-    rcompute_timer_begin();
-    rcompute_dispatch_2d(&ctx, (WIDTH + 15) / 16, (HEIGHT + 15) / 16);
-    rcompute_barrier_all();
-    double time1 = rcompute_timer_end();
+    double time1 = bench_time("blur_horizontal", [&]() {
+        rcompute_dispatch_2d(&ctx, (WIDTH + 15) / 16, (HEIGHT + 15) / 16);
+    });
     printf("  Completed in %.3f ms\n", time1);
     
     // Pass 2: Vertical blur (temp -> output)
@@ -94,15 +94,16 @@ int main()
     rcompute_texture_bind(tex_output, 1, GL_RGBA32F);
     rcompute_set_uniform_int(&ctx, "horizontal", 0);
     
-    rcompute_timer_begin();
-    rcompute_dispatch_2d(&ctx, (WIDTH + 15) / 16, (HEIGHT + 15) / 16);
-    rcompute_barrier_all();
-    double time2 = rcompute_timer_end();
+    double time2 = bench_time("blur_vertical", [&]() {
+        rcompute_dispatch_2d(&ctx, (WIDTH + 15) / 16, (HEIGHT + 15) / 16);
+        rcompute_barrier(GL_TEXTURE_UPDATE_BARRIER_BIT); // glGetTexImage below bypasses rcompute
+    });
     printf("  Completed in %.3f ms\n", time2);
+    rcompute_arena_end(arena);
     
     printf("\nTotal blur time: %.3f ms\n", time1 + time2);
     printf("Throughput: %.2f Mpixels/sec\n", 
-           (WIDTH * HEIGHT * 2 / 1e6) / ((time1 + time2) / 1000.0));
+           bench_per_second((double)WIDTH * HEIGHT * 2 / 1e6, time1 + time2));
     
     // Read back result
     float *output_data = new float[WIDTH * HEIGHT * 4];
@@ -114,9 +115,9 @@ int main()
     delete[] input_data;
     delete[] output_data;
     rcompute_texture_destroy(tex_input);
-    rcompute_texture_destroy(tex_temp);
+    rcompute_arena_destroy(arena);
     rcompute_texture_destroy(tex_output);
     rcompute_destroy(&ctx);
     
-    return 0;
+    return bench_finish();
 }
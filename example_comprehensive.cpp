@@ -85,8 +85,12 @@ void demo_reduction()
     int num_workgroups = (N + 255) / 256;
     std::vector<float> partial_sums(num_workgroups);
 
+    // Partial sums are scratch: take them from a transient arena instead of a dedicated buffer
+    rcompute_arena *arena = rcompute_arena_create(num_workgroups * sizeof(float));
+    rcompute_arena_begin(arena);
+
     GLuint buf_in = rcompute_buffer(N * sizeof(float), values.data());
-    GLuint buf_out = rcompute_buffer(num_workgroups * sizeof(float), nullptr);
+    GLuint buf_out = rcompute_arena_buffer(arena, num_workgroups * sizeof(float));
 
     rcompute_buffer_bind(buf_in, 0);
     rcompute_buffer_bind(buf_out, 1);
@@ -96,6 +100,7 @@ void demo_reduction()
     rcompute_run(&c, num_workgroups, 1, 1);
 
     rcompute_read(buf_out, partial_sums.data(), num_workgroups * sizeof(float));
+    rcompute_arena_end(arena);
 
     // Final reduction on CPU
     float total = 0.0f;
@@ -105,7 +110,7 @@ void demo_reduction()
     std::cout << "Sum of " << N << " values: " << total << " (expected: " << N << ")\n";
 
     rcompute_buffer_destroy(buf_in);
-    rcompute_buffer_destroy(buf_out);
+    rcompute_arena_destroy(arena);
     rcompute_destroy(&c);
 }
 
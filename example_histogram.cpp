@@ -3,6 +3,7 @@
 
 #define RCOMPUTE_IMPLEMENTATION
 #include "include/rcompute.h"
+#include "example_bench.h"
 #include <stdio.h>
 #include <math.h>
 
@@ -38,12 +39,15 @@ void print_histogram_bars(const unsigned int *bins, int total)
     }
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    if (!bench_init(argc, argv, "example_histogram"))
+        return 1;
+    
     printf("=== Image Histogram with Atomics ===\n\n");
     
-    const int WIDTH = 1024;
-    const int HEIGHT = 1024;
+    const int WIDTH = bench_size(1024);  // --size sets the image edge
+    const int HEIGHT = WIDTH;
     
     rcompute ctx;
     if (!rcompute_init(&ctx, 4, 3)) {
@@ -70,10 +74,10 @@ int main()
     rcompute_buffer_bind(hist_buf, 0);
     
     printf("Computing histogram...\n");
-    rcompute_timer_begin();
-    rcompute_dispatch_2d(&ctx, (WIDTH + 15) / 16, (HEIGHT + 15) / 16);
-    rcompute_barrier_all();
-    double elapsed = rcompute_timer_end();
+    // bins accumulate, so every repetition starts from cleared ones
+    double elapsed = bench_time("histogram", [&]() {
+        rcompute_dispatch_2d(&ctx, (WIDTH + 15) / 16, (HEIGHT + 15) / 16);
+    }, [&]() { rcompute_buffer_clear(hist_buf, 0, 0); });
     
     // Read results
     unsigned int *histogram = new unsigned int[256];
@@ -81,7 +85,7 @@ int main()
     
     printf("Computed in %.3f ms\n", elapsed);
     printf("Throughput: %.2f Mpixels/sec\n",
-           (WIDTH * HEIGHT / 1e6) / (elapsed / 1000.0));
+           bench_per_second((double)WIDTH * HEIGHT / 1e6, elapsed));
     
     // Verify total count
     unsigned int total = 0;
@@ -90,7 +94,7 @@ int main()
     
     printf("\nTotal pixels counted: %u (expected: %d)\n", total, WIDTH * HEIGHT);
     
-    if (total == WIDTH * HEIGHT)
+    if (total == (unsigned int)(WIDTH * HEIGHT))
         printf("✓ Histogram is correct!\n");
     
     print_histogram_bars(histogram, total);
@@ -101,5 +105,5 @@ int main()
     rcompute_buffer_destroy(hist_buf);
     rcompute_destroy(&ctx);
     
-    return 0;
+    return bench_finish();
 }
@@ -3,6 +3,7 @@
 
 #define RCOMPUTE_IMPLEMENTATION
 #include "include/rcompute.h"
+#include "example_bench.h"
 #include <stdio.h>
 
 void write_ppm(const char *filename, const float *data, int width, int height)
@@ -22,12 +23,15 @@ void write_ppm(const char *filename, const float *data, int width, int height)
     fclose(f);
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    if (!bench_init(argc, argv, "example_mandelbrot"))
+        return 1;
+    
     printf("=== Mandelbrot Fractal Generator ===\n\n");
     
-    const int WIDTH = 1920;
-    const int HEIGHT = 1080;
+    const int WIDTH = bench_size(1920);  // --size sets the width of a 16:9 image
+    const int HEIGHT = WIDTH * 9 / 16;
     
     rcompute ctx;
     if (!rcompute_init(&ctx, 4, 3)) {
@@ -50,11 +54,12 @@ int main()
         float cx, cy, zoom;
         int iterations;
         const char *name;
+        const char *section;
     } scenes[] = {
-        {-0.5f, 0.0f, 4.0f, 256, "mandelbrot_full.ppm"},
-        {-0.7f, 0.0f, 1.0f, 512, "mandelbrot_zoom1.ppm"},
-        {-0.743643f, 0.131825f, 0.01f, 1024, "mandelbrot_zoom2.ppm"},
-        {-0.743643f, 0.131825f, 0.001f, 2048, "mandelbrot_zoom3.ppm"}
+        {-0.5f, 0.0f, 4.0f, 256, "mandelbrot_full.ppm", "mandelbrot_full"},
+        {-0.7f, 0.0f, 1.0f, 512, "mandelbrot_zoom1.ppm", "mandelbrot_zoom1"},
+        {-0.743643f, 0.131825f, 0.01f, 1024, "mandelbrot_zoom2.ppm", "mandelbrot_zoom2"},
+        {-0.743643f, 0.131825f, 0.001f, 2048, "mandelbrot_zoom3.ppm", "mandelbrot_zoom3"}
     };
     
     float *output = new float[WIDTH * HEIGHT * 4];
@@ -67,10 +72,10 @@ int main()
         rcompute_set_uniform_float(&ctx, "zoom", scenes[i].zoom);
         rcompute_set_uniform_int(&ctx, "maxIterations", scenes[i].iterations);
         
-        rcompute_timer_begin();
-        rcompute_dispatch_2d(&ctx, (WIDTH + 15) / 16, (HEIGHT + 15) / 16);
-        rcompute_barrier_all();
-        double elapsed = rcompute_timer_end();
+        double elapsed = bench_time(scenes[i].section, [&]() {
+            rcompute_dispatch_2d(&ctx, (WIDTH + 15) / 16, (HEIGHT + 15) / 16);
+            rcompute_barrier_all();
+        });
         
         printf("  Rendered in %.2f ms\n", elapsed);
         
@@ -87,5 +92,5 @@ int main()
     rcompute_destroy(&ctx);
     
     printf("Done! View the .ppm files to see the fractals.\n");
-    return 0;
+    return bench_finish();
 }
@@ -3,15 +3,20 @@
 
 #define RCOMPUTE_IMPLEMENTATION
 #include "include/rcompute.h"
+#include "example_bench.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 
-int main()
+int main(int argc, char **argv)
 {
+    if (!bench_init(argc, argv, "example_monte_carlo"))
+        return 1;
+    
     printf("=== Monte Carlo π Estimation ===\n\n");
     
-    const int THREADS = 65536;  // 256 work groups × 256 threads
+    // 256 work groups × 256 threads; --size sets the thread count, rounded up to whole groups
+    const int THREADS = (bench_size(65536) + 255) / 256 * 256;
     const int SAMPLES_PER_THREAD = 1000;
     const long long TOTAL_SAMPLES = (long long)THREADS * SAMPLES_PER_THREAD;
     
@@ -30,18 +35,18 @@ int main()
     printf("Sampling %lld random points...\n", TOTAL_SAMPLES);
     printf("Using %d GPU threads\n\n", THREADS);
     
-    // Create result buffer: [hits, total]
-    unsigned int results[2] = {0, 0};
-    GLuint buf = rcompute_buffer(2 * sizeof(unsigned int), results);
+    // Create result buffer: [hits, total], zeroed on the GPU
+    unsigned int results[2];
+    GLuint buf = rcompute_buffer_zero(2 * sizeof(unsigned int));
     rcompute_buffer_bind(buf, 0);
     
-    // Use random seed
+    // rand() is seeded by bench_init (--seed), so runs are reproducible
     rcompute_set_uniform_uint(&ctx, "seed_base", (unsigned int)rand());
     
-    rcompute_timer_begin();
-    rcompute_dispatch_1d(&ctx, THREADS / 256);
-    rcompute_barrier_all();
-    double elapsed = rcompute_timer_end();
+    // the counters accumulate, so every repetition starts from zero
+    double elapsed = bench_time("monte_carlo", [&]() {
+        rcompute_dispatch_1d(&ctx, THREADS / 256);
+    }, [&]() { rcompute_buffer_clear(buf, 0, 0); });
     
     // Read results
     rcompute_read(buf, results, 2 * sizeof(unsigned int));
@@ -61,10 +66,10 @@ int main()
     printf("  Error: %.10f (%.4f%%)\n", error, error_percent);
     printf("\nGPU time: %.2f ms\n", elapsed);
     printf("Sampling rate: %.2f billion samples/sec\n",
-           (TOTAL_SAMPLES / 1e9) / (elapsed / 1000.0));
+           bench_per_second(TOTAL_SAMPLES / 1e9, elapsed));
     
     rcompute_buffer_destroy(buf);
     rcompute_destroy(&ctx);
     
-    return 0;
+    return bench_finish();
 }
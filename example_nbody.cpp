@@ -3,6 +3,7 @@
 
 #define RCOMPUTE_IMPLEMENTATION
 #include "include/rcompute.h"
+#include "example_bench.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
@@ -12,13 +13,16 @@ struct Particle {
     float vel[4];  // vx, vy, vz, unused
 };
 
-float randf() { return (float)rand() / RAND_MAX; }
+float randf() { return (float)rand() / RAND_MAX; } // seeded by bench_init (--seed)
 
-int main()
+int main(int argc, char **argv)
 {
+    if (!bench_init(argc, argv, "example_nbody"))
+        return 1;
+    
     printf("=== N-Body Gravitational Simulation ===\n\n");
     
-    const int N = 4096;
+    const int N = bench_size(4096);  // --size sets the body count
     const int STEPS = 1000;
     const float DT = 0.001f;
     const float SOFTENING = 0.001f;
@@ -58,40 +62,56 @@ int main()
         particles[i].vel[3] = 0.0f;
     }
     
-    GLuint buffer = rcompute_buffer(N * sizeof(Particle), particles);
-    rcompute_buffer_bind(buffer, 0);
+    // Double-buffered state: each step reads the front (binding 0) and writes the back (binding 1),
+    // so no work group sees another group's half-updated particles
+    rcompute_pingpong state;
+    rcompute_pingpong_buffers(&state, N * sizeof(Particle), particles, 0, 1);
     
     // Set uniforms
     rcompute_set_uniform_float(&ctx, "dt", DT);
     rcompute_set_uniform_float(&ctx, "softening", SOFTENING);
     rcompute_set_uniform_int(&ctx, "numBodies", N);
     
+    // Per-kernel bandwidth and throughput, measured alongside the timer scopes
+    rcompute_dispatch_stats_enable(1);
+    
     // Simulation loop
     printf("Running %d simulation steps...\n", STEPS);
     printf("Progress: ");
     fflush(stdout);
     
-    double total_time = 0.0;
     for (int step = 0; step < STEPS; step++) {
         if (step % 100 == 0) {
             printf("%d ", step);
             fflush(stdout);
         }
         
-        rcompute_timer_begin();
+        // Pooled timer: results are collected a few steps later, so the CPU never waits
+        rcompute_timer_push("nbody step");
         rcompute_dispatch_1d(&ctx, (N + 255) / 256);
-        rcompute_barrier_all();
-        total_time += rcompute_timer_end();
+        rcompute_pingpong_swap(&state);
+        rcompute_timer_pop();
     }
     
+    rcompute_timer_collect(1);
+    rcompute_timer_stats stats;
+    rcompute_timer_stats_get("nbody step", &stats);
+    double total_time = stats.total_ms;
+    
     printf("\n\nSimulation complete!\n");
     printf("Total GPU time: %.2f ms\n", total_time);
-    printf("Average per step: %.3f ms\n", total_time / STEPS);
+    printf("Average per step: %.3f ms (last %d: %.3f, min %.3f, max %.3f)\n", total_time / STEPS,
+           RCOMPUTE_TIMER_WINDOW, stats.avg_ms, stats.min_ms, stats.max_ms);
     printf("Interactions per second: %.2f million\n", 
-           (N * N * STEPS / 1e6) / (total_time / 1000.0));
+           bench_per_second((double)N * N * STEPS / 1e6, total_time));
+    
+    rcompute_dispatch_stats kernel;
+    if (rcompute_dispatch_stats_get(ctx.program, &kernel))
+        printf("Kernel: %.3f GB/s of bound buffers, %.2f million invocations/s\n",
+               kernel.gb_per_s, kernel.invocations_per_s / 1e6);
     
     // Read final state
-    rcompute_read(buffer, particles, N * sizeof(Particle));
+    rcompute_read(rcompute_pingpong_front(&state), particles, N * sizeof(Particle));
     
     // Calculate center of mass and bounds
     float cx = 0, cy = 0, cz = 0, total_mass = 0;
@@ -124,9 +144,18 @@ int main()
     printf("  Bounds Y: [%.3f, %.3f]\n", min_y, max_y);
     printf("  Bounds Z: [%.3f, %.3f]\n", min_z, max_z);
     
+    // Benchmark mode times single steps with the GPU drained around each one; the pooled timers
+    // above never wait, so they are left to describe the simulation. This runs after the report,
+    // so the printed final state is the same with or without --bench.
+    if (bench_enabled())
+        bench_time("nbody_step", [&]() {
+            rcompute_dispatch_1d(&ctx, (N + 255) / 256);
+            rcompute_pingpong_swap(&state);
+        });
+    
     delete[] particles;
-    rcompute_buffer_destroy(buffer);
+    rcompute_pingpong_destroy(&state);
     rcompute_destroy(&ctx);
     
-    return 0;
+    return bench_finish();
 }
@@ -3,6 +3,7 @@
 
 #define RCOMPUTE_IMPLEMENTATION
 #include "include/rcompute.h"
+#include "example_bench.h"
 
 #include <cmath>
 #include <cstdint>
@@ -71,12 +72,15 @@ static Vec3 palette(float t)
     return result;
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    if (!bench_init(argc, argv, "example_nebulabrot"))
+        return 1;
+    
     printf("=== Nebulabrot Fractal Generator ===\n\n");
 
-    const int WIDTH = 1920;
-    const int HEIGHT = 1080;
+    const int WIDTH = bench_size(1920);  // --size sets the width of a 16:9 image
+    const int HEIGHT = WIDTH * 9 / 16;
 
     // Tunable parameters
     const int SAMPLES_PER_INVOCATION = 64;  // more samples = richer image, slower runtime
@@ -84,7 +88,7 @@ int main()
     const int MIN_ITERATIONS = 20;          // filter out short-lived orbits
     const int WORKGROUPS_X = 256;
     const int WORKGROUPS_Y = 144;
-    const unsigned int SEED = 1337u;
+    const unsigned int SEED = bench_seed();
 
     const float VIEW_MIN_X = -2.2f;
     const float VIEW_MAX_X = 1.2f;
@@ -107,10 +111,12 @@ int main()
     GLuint accum_tex = rcompute_texture_2d(WIDTH, HEIGHT, GL_R32UI, NULL);
     rcompute_texture_bind(accum_tex, 0, GL_R32UI);
 
-    // Clear accumulation buffer
+    // Accumulation starts from zero on every repetition
     std::vector<uint32_t> zero_data(static_cast<size_t>(WIDTH) * HEIGHT, 0);
-    glBindTexture(GL_TEXTURE_2D, accum_tex);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, WIDTH, HEIGHT, GL_RED_INTEGER, GL_UNSIGNED_INT, zero_data.data());
+    auto clear_accum = [&]() {
+        glBindTexture(GL_TEXTURE_2D, accum_tex);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, WIDTH, HEIGHT, GL_RED_INTEGER, GL_UNSIGNED_INT, zero_data.data());
+    };
 
     rcompute_set_uniform_uint(&ctx, "seed", SEED);
     rcompute_set_uniform_int(&ctx, "samplesPerInvocation", SAMPLES_PER_INVOCATION);
@@ -124,10 +130,10 @@ int main()
     printf("Dispatching ~%llu orbits (each GPU invocation traces %d samples)\n",
            total_samples, SAMPLES_PER_INVOCATION);
 
-    rcompute_timer_begin();
-    rcompute_dispatch_2d(&ctx, WORKGROUPS_X, WORKGROUPS_Y);
-    rcompute_barrier_all();
-    double elapsed_ms = rcompute_timer_end();
+    double elapsed_ms = bench_time("nebulabrot_accumulate", [&]() {
+        rcompute_dispatch_2d(&ctx, WORKGROUPS_X, WORKGROUPS_Y);
+        rcompute_barrier_all();
+    }, clear_accum);
     printf("Accumulation completed in %.2f ms\n", elapsed_ms);
 
     // Read back counts
@@ -168,5 +174,5 @@ int main()
     rcompute_destroy(&ctx);
 
     printf("Done! View the PPM to see the Nebulabrot.\n");
-    return 0;
+    return bench_finish();
 }
@@ -2,6 +2,13 @@
 #include "include/rcompute.h"
 #include <iostream>
 #include <iomanip>
+#include <string>
+#include <stdlib.h>
+#include <stdio.h>
+#ifndef _WIN32
+#include <dirent.h>
+#include <unistd.h>
+#endif
 
 void demo_uniform_helpers() {
     std::cout << "=== Uniform Helpers Demo ===\n";
@@ -201,21 +208,167 @@ void main() {
     
     rcompute_dispatch_1d(&c, 1);
     
-    // Use custom barrier instead of automatic one
-    rcompute_barrier(GL_SHADER_STORAGE_BARRIER_BIT);
-    
+    // rcompute_read infers the barrier it needs
     int result[5];
     rcompute_read(buf, result, sizeof(result));
     
     std::cout << "First 5 values (doubled): ";
     for (int i = 0; i < 5; i++)
         std::cout << result[i] << " ";
-    std::cout << "\n\n";
+    std::cout << "\n";
+    
+    // Raw GL reads bypass rcompute's hazard tracking, so they need an explicit barrier
+    rcompute_dispatch_1d(&c, 1);
+    rcompute_barrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    int last = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 255 * sizeof(int), sizeof(int), &last);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    std::cout << "Last value via glGetBufferSubData: " << last << "\n\n";
     
     rcompute_buffer_destroy(buf);
     rcompute_destroy(&c);
 }
 
+void demo_indirect() {
+    std::cout << "=== Indirect Dispatch Demo ===\n";
+    
+    rcompute c;
+    rcompute_init(&c, 4, 3);
+    
+    // Pass 1 keeps the values above a threshold; pass 2 runs once per survivor
+    const char *compact = R"(
+#version 430
+layout(local_size_x = 256) in;
+layout(std430, binding = 0) readonly buffer In { int values[]; };
+layout(std430, binding = 1) buffer Out { uint count; int kept[]; };
+
+void main() {
+    uint gid = gl_GlobalInvocationID.x;
+    if (values[gid] >= 900)
+        kept[atomicAdd(count, 1u)] = values[gid];
+}
+)";
+    const char *square = R"(
+#version 430
+layout(local_size_x = 64) in;
+layout(std430, binding = 1) buffer Out { uint count; int kept[]; };
+
+void main() {
+    uint gid = gl_GlobalInvocationID.x;
+    if (gid < count)
+        kept[gid] = kept[gid] * 2;
+}
+)";
+    
+    int values[1024];
+    for (int i = 0; i < 1024; i++)
+        values[i] = (i * 37) % 1000;
+    
+    GLuint in = rcompute_buffer(sizeof(values), values);
+    GLuint out = rcompute_buffer_zero(sizeof(GLuint) + sizeof(values));
+    GLuint args = rcompute_buffer_zero(3 * sizeof(GLuint));
+    rcompute_buffer_bind(in, 0);
+    rcompute_buffer_bind(out, 1);
+    
+    GLuint compact_prog = rcompute_compile(compact);
+    GLuint square_prog = rcompute_compile(square);
+    
+    c.program = compact_prog;
+    rcompute_dispatch_items_1d(&c, 1024);
+    
+    // The survivor count never leaves the GPU
+    rcompute_indirect_args(&c, out, 0, args, 0, 64);
+    c.program = square_prog;
+    rcompute_run_indirect(&c, args, 0);
+    
+    // count followed by the first survivors
+    int head[5];
+    rcompute_read(out, head, sizeof(head));
+    GLuint groups[3];
+    rcompute_read(args, groups, sizeof(groups));
+    std::cout << "Survivors: " << head[0] << " (expected: 100), groups: " << groups[0] << "\n";
+    std::cout << "First survivors doubled: ";
+    for (int i = 1; i < 5; i++)
+        std::cout << head[i] << " ";
+    std::cout << "\n\n";
+    
+    rcompute_program_destroy(compact_prog);
+    rcompute_buffer_destroy(in);
+    rcompute_buffer_destroy(out);
+    rcompute_buffer_destroy(args);
+    rcompute_destroy(&c);
+}
+
+void demo_cache_reflection() {
+    std::cout << "=== Warm Cache Async Reflection Demo ===\n";
+#ifdef _WIN32
+    std::cout << "Skipped: needs a POSIX temporary directory\n\n";
+#else
+    char dir[] = "/tmp/rcompute_cache_XXXXXX";
+    if (!mkdtemp(dir)) {
+        std::cout << "Skipped: cannot create a temporary cache directory\n\n";
+        return;
+    }
+    
+    rcompute c;
+    rcompute_init(&c, 4, 3);
+    rcompute_set_cache_dir(dir);
+    
+    const char *shader = R"(
+#version 430
+layout(local_size_x = 256) in;
+layout(std430, binding = 0) readonly buffer In { float src[]; };
+layout(std430, binding = 1) writeonly buffer Out { float dst[]; };
+shared float tile[256];
+
+void main() {
+    tile[gl_LocalInvocationID.x] = src[gl_GlobalInvocationID.x];
+    barrier();
+    dst[gl_GlobalInvocationID.x] = tile[255u - gl_LocalInvocationID.x];
+}
+)";
+    
+    // The first compile links and stores a binary; the second loads it from the cache
+    std::string seen[2];
+    for (int pass = 0; pass < 2; pass++) {
+        GLuint prog = 0;
+        rcompute_compile_async(&shader, 1, &prog);
+        if (rcompute_compile_wait(&prog) != RCOMPUTE_COMPILE_READY) {
+            std::cout << "Compile failed: " << rcompute_get_last_error() << "\n";
+            break;
+        }
+        const rcompute_reflection *r = rcompute_reflect(prog);
+        for (int i = 0; r && i < r->block_count; i++)
+            seen[pass] += std::string(r->blocks[i].name) + (r->blocks[i].readonly ? " readonly" : "") +
+                          (r->blocks[i].writeonly ? " writeonly" : "") + ", ";
+        if (r)
+            seen[pass] += "shared " + std::to_string(r->shared_bytes) + " bytes";
+        rcompute_program_destroy(prog);
+    }
+    
+    int hits, misses;
+    rcompute_get_cache_stats(&hits, &misses);
+    std::cout << "Cold: " << seen[0] << "\nWarm: " << seen[1] << "\n";
+    std::cout << "Cache hits: " << hits << ", misses: " << misses << "\n";
+    if (hits > 0 && !seen[0].empty() && seen[0] == seen[1])
+        std::cout << "✓ Warm start reflects the same qualifiers\n";
+    std::cout << "\n";
+    
+    rcompute_set_cache_dir(NULL);
+    rcompute_destroy(&c);
+    
+    if (DIR *d = opendir(dir)) {
+        while (dirent *e = readdir(d)) {
+            if (e->d_name[0] != '.')
+                remove((std::string(dir) + "/" + e->d_name).c_str());
+        }
+        closedir(d);
+    }
+    rmdir(dir);
+#endif
+}
+
 int main() {
     std::cout << "\n=== RCompute New Features Demo ===\n\n";
     
@@ -225,6 +378,8 @@ int main() {
     demo_timing();
     demo_limits();
     demo_barriers();
+    demo_indirect();
+    demo_cache_reflection();
     
     std::cout << "=== All demos completed ===\n";
     return 0;
@@ -3,9 +3,16 @@
 
 #define RCOMPUTE_IMPLEMENTATION
 #include "include/rcompute.h"
+#include "example_bench.h"
 #include <stdio.h>
 #include <math.h>
 
+// Matches the std140 Params block in example_raytracer.comp
+struct Params {
+    float camPos[3]; // vec3 (16-byte aligned, time packs into the 4th slot)
+    float time;
+};
+
 void write_ppm(const char *filename, const float *data, int width, int height)
 {
     FILE *f = fopen(filename, "wb");
@@ -22,12 +29,15 @@ void write_ppm(const char *filename, const float *data, int width, int height)
     fclose(f);
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    if (!bench_init(argc, argv, "example_raytracer"))
+        return 1;
+    
     printf("=== Simple Raytracer ===\n\n");
     
-    const int WIDTH = 1280;
-    const int HEIGHT = 720;
+    const int WIDTH = bench_size(1280);  // --size sets the width of a 16:9 frame
+    const int HEIGHT = WIDTH * 9 / 16;
     const int FRAMES = 120;
     
     rcompute ctx;
@@ -52,6 +62,7 @@ int main()
     fflush(stdout);
     
     double total_time = 0.0;
+    double frame_ms[FRAMES];
     
     for (int frame = 0; frame < FRAMES; frame++) {
         if (frame % 10 == 0) {
@@ -64,13 +75,16 @@ int main()
         float cam_y = 1.0f + sin(t * 0.3f) * 0.5f;
         float cam_z = cos(t * 0.5f) * 3.0f;
         
-        rcompute_set_uniform_vec3(&ctx, "camPos", cam_x, cam_y, cam_z);
-        rcompute_set_uniform_float(&ctx, "time", t);
+        Params params = {{cam_x, cam_y, cam_z}, t};
+        rcompute_set_params(&ctx, 0, &params, sizeof(params));
         
-        rcompute_timer_begin();
-        rcompute_dispatch_2d(&ctx, (WIDTH + 15) / 16, (HEIGHT + 15) / 16);
-        rcompute_barrier_all();
-        total_time += rcompute_timer_end();
+        // every frame is different, so frames are the samples rather than repeats of one frame
+        double gpu_ms;
+        frame_ms[frame] = bench_once([&]() {
+            rcompute_dispatch_2d(&ctx, (WIDTH + 15) / 16, (HEIGHT + 15) / 16);
+            rcompute_barrier_all();
+        }, &gpu_ms);
+        total_time += gpu_ms;
         
         // Save a few keyframes
         if (frame == 0 || frame == 30 || frame == 60 || frame == 90) {
@@ -83,12 +97,16 @@ int main()
         }
     }
     
+    // the first --warmup frames warm caches and are left out of the benchmark statistics
+    int skip = bench.warmup < FRAMES ? bench.warmup : FRAMES - 1;
+    bench_record("raytrace_frame", "ms", frame_ms + skip, FRAMES - skip);
+    
     printf("\n\nRendering complete!\n");
     printf("Total time: %.2f ms\n", total_time);
     printf("Average per frame: %.2f ms (%.1f FPS)\n", 
-           total_time / FRAMES, 1000.0 * FRAMES / total_time);
+           total_time / FRAMES, bench_per_second(FRAMES, total_time));
     printf("Throughput: %.2f Mpixels/sec\n",
-           (WIDTH * HEIGHT * FRAMES / 1e6) / (total_time / 1000.0));
+           bench_per_second((double)WIDTH * HEIGHT * FRAMES / 1e6, total_time));
     
     printf("\nSaved frames: raytrace_frame000.ppm, frame030.ppm, frame060.ppm, frame090.ppm\n");
     
@@ -96,5 +114,5 @@ int main()
     rcompute_texture_destroy(output_tex);
     rcompute_destroy(&ctx);
     
-    return 0;
+    return bench_finish();
 }
@@ -3,10 +3,14 @@
 
 #define RCOMPUTE_IMPLEMENTATION
 #include "include/rcompute.h"
+#include "example_bench.h"
 #include <stdio.h>
 
-int main()
+int main(int argc, char **argv)
 {
+    if (!bench_init(argc, argv, "example_scan"))
+        return 1;
+    
     printf("=== Parallel Prefix Sum (Scan) ===\n\n");
     
     const int N = 512;  // Must be power of 2 for this simple implementation
@@ -38,10 +42,9 @@ int main()
     rcompute_buffer_bind(buf_out, 1);
     rcompute_set_uniform_int(&ctx, "n", N);
     
-    rcompute_timer_begin();
-    rcompute_dispatch_1d(&ctx, 1);  // Single work group
-    rcompute_barrier_all();
-    double elapsed = rcompute_timer_end();
+    double elapsed = bench_time("scan", [&]() {
+        rcompute_dispatch_1d(&ctx, 1);  // Single work group
+    });
     
     rcompute_read(buf_out, output, N * sizeof(int));
     
@@ -78,5 +81,5 @@ int main()
     rcompute_buffer_destroy(buf_out);
     rcompute_destroy(&ctx);
     
-    return 0;
+    return bench_finish();
 }
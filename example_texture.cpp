@@ -3,6 +3,7 @@
 
 #define RCOMPUTE_IMPLEMENTATION
 #include "include/rcompute.h"
+#include "example_bench.h"
 #include <stdio.h>
 #include <math.h>
 
@@ -64,13 +65,16 @@ void write_ppm(const char *filename, const float *data, int width, int height)
     printf("Wrote image to %s\n", filename);
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    if (!bench_init(argc, argv, "example_texture"))
+        return 1;
+    
     printf("=== RCompute Texture Processing Example ===\n\n");
     
-    // Image dimensions
-    const int WIDTH = 512;
-    const int HEIGHT = 512;
+    // Image dimensions (--size sets the edge)
+    const int WIDTH = bench_size(512);
+    const int HEIGHT = WIDTH;
     const int CHANNELS = 4; // RGBA
     
     // Initialize
@@ -118,10 +122,10 @@ int main()
     int groups_y = (HEIGHT + 15) / 16;
     
     printf("Processing image (dispatching %dx%d work groups)...\n", groups_x, groups_y);
-    rcompute_timer_begin();
-    rcompute_dispatch_2d(&ctx, groups_x, groups_y);
-    rcompute_barrier_all();
-    double elapsed = rcompute_timer_end();
+    double elapsed = bench_time("texture_edges", [&]() {
+        rcompute_dispatch_2d(&ctx, groups_x, groups_y);
+        rcompute_barrier_all();
+    });
     
     printf("Processing completed in %.3f ms\n", elapsed);
     
@@ -166,5 +170,5 @@ int main()
     printf("\n=== Processing complete! ===\n");
     printf("View results: input.ppm and output.ppm\n");
     
-    return 0;
+    return bench_finish();
 }
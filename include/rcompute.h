@@ -4,8 +4,25 @@
 #define RCOMPUTE_H
 
 // User must link with: -lGLEW -lGL -lglfw
+//
+// Optional headless backend:
+//   #define RCOMPUTE_USE_EGL  - compile the EGL surfaceless backend (link -lEGL)
+//   #define RCOMPUTE_NO_GLFW  - drop the GLFW backend entirely (requires RCOMPUTE_USE_EGL)
+
+// strict -std=c99/c11 hides clock_gettime; only takes effect if nothing was included before us
+#if defined(RCOMPUTE_IMPLEMENTATION) && defined(__STRICT_ANSI__) && !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
 #include <GL/glew.h>
+#ifndef RCOMPUTE_NO_GLFW
 #include <GLFW/glfw3.h>
+#else
+typedef struct GLFWwindow GLFWwindow;
+#endif
+
+#if defined(RCOMPUTE_NO_GLFW) && !defined(RCOMPUTE_USE_EGL)
+#error "RCOMPUTE_NO_GLFW requires RCOMPUTE_USE_EGL"
+#endif
 
 #ifdef __cplusplus
 extern "C"
@@ -24,16 +41,34 @@ extern "C"
         RCOMPUTE_STREAM = 2   // GL_STREAM_COPY
     } rcompute_usage;
 
+    // Context creation backends
+    typedef enum
+    {
+        RCOMPUTE_BACKEND_AUTO = 0, // $RCOMPUTE_BACKEND, else EGL (if compiled in), else GLFW
+        RCOMPUTE_BACKEND_GLFW = 1, // hidden 1x1 GLFW window
+        RCOMPUTE_BACKEND_EGL = 2   // surfaceless EGL context, no window system needed
+    } rcompute_backend;
+
     typedef struct
     {
         GLFWwindow *window;
         GLuint program;
-        GLuint last_program; // Cache for optimization
+        GLuint last_program; // program currently bound with glUseProgram
+        rcompute_backend backend; // backend that created the context
+        void *egl_display;        // EGLDisplay (EGL backend only)
+        void *egl_context;        // EGLContext (EGL backend only)
+        GLuint param_ubo;          // ring-allocated UBO for rcompute_set_params
+        GLsizeiptr param_ubo_size;
+        GLsizeiptr param_ubo_head;
+        GLint param_ubo_align;     // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, queried with the ring
     } rcompute;
 
     // create OpenGL context + window (hidden)
     int rcompute_init(rcompute *c, int gl_major, int gl_minor);
 
+    // create OpenGL context with an explicit backend
+    int rcompute_init_ex(rcompute *c, int gl_major, int gl_minor, rcompute_backend backend);
+
     // compile a compute shader from a string
     GLuint rcompute_compile(const char *src);
 
@@ -43,12 +78,95 @@ extern "C"
     // compile a compute shader with preprocessor defines
     GLuint rcompute_compile_with_defines(const char *src, const char **defines, int count);
 
+    // memoized rcompute_compile_with_defines: same source + define set returns the same
+    // linked program (define order/whitespace doesn't matter). Each call adds a reference.
+    GLuint rcompute_compile_variant(const char *src, const char **defines, int count);
+
+    // drop a reference; the program stays cached until evicted
+    void rcompute_release_variant(GLuint program);
+
+    // delete unreferenced variants (or all variants if force != 0); returns number evicted
+    int rcompute_evict_variants(int force);
+
+    // Async compile status
+    typedef enum
+    {
+        RCOMPUTE_COMPILE_FAILED = -1,
+        RCOMPUTE_COMPILE_PENDING = 0,
+        RCOMPUTE_COMPILE_READY = 1
+    } rcompute_compile_status;
+
+    // submit many compute shaders at once; programs[i] receives a pending handle (0 on immediate failure)
+    // returns the number of handles submitted
+    int rcompute_compile_async(const char **sources, int count, GLuint *programs);
+
+    // poll a pending program without blocking (if GL_KHR_parallel_shader_compile is available)
+    // on failure the program is deleted and *program is set to 0
+    int rcompute_compile_poll(GLuint *program);
+
+    // block until a pending program is linked; returns 1 on success, 0 on failure
+    int rcompute_compile_wait(GLuint *program);
+
+    // wait for every handle; failed entries are set to 0. returns number of ready programs
+    int rcompute_compile_wait_all(GLuint *programs, int count);
+
+    // persistent program binary cache (NULL disables; default: $RCOMPUTE_CACHE_DIR)
+    void rcompute_set_cache_dir(const char *dir);
+    void rcompute_get_cache_stats(int *hits, int *misses);
+
     // reload shader from file (hot-reload support)
     int rcompute_reload_shader(rcompute *c, const char *filepath);
 
     // set active program for compute context
     void rcompute_set_program(rcompute *c, GLuint program);
 
+    // delete a program and its cached metadata (use instead of glDeleteProgram)
+    void rcompute_program_destroy(GLuint program);
+
+    // Program reflection (glGetProgramResourceiv + GL_COMPUTE_WORK_GROUP_SIZE). Qualifiers and
+    // image formats come from the source; readonly and writeonly both 0 means read-write or unknown.
+    typedef struct
+    {
+        char name[64];
+        GLuint binding;
+        GLint size;        // GL_BUFFER_DATA_SIZE: fixed part, one element of a trailing unsized array
+        int readonly;
+        int writeonly;
+    } rcompute_reflect_block;
+
+    typedef struct
+    {
+        char name[64];
+        GLuint unit;
+        GLenum type;       // GL_IMAGE_2D, GL_UNSIGNED_INT_IMAGE_3D, ...
+        GLenum format;     // layout qualifier, e.g. GL_RGBA32F; 0 if not found
+        int readonly;
+        int writeonly;
+    } rcompute_reflect_image;
+
+    typedef struct
+    {
+        char name[64];
+        GLint location;
+        GLenum type;
+        GLint array_size;
+    } rcompute_reflect_uniform;
+
+    typedef struct
+    {
+        int local_size[3];
+        int shared_bytes;  // estimated from `shared` declarations; -1 if unknown
+        int block_count;
+        const rcompute_reflect_block *blocks;
+        int image_count;
+        const rcompute_reflect_image *images;
+        int uniform_count; // default-block uniforms, images included
+        const rcompute_reflect_uniform *uniforms;
+    } rcompute_reflection;
+
+    // owned by rcompute, valid until the program is destroyed; NULL on failure
+    const rcompute_reflection *rcompute_reflect(GLuint program);
+
     // Uniform helpers (must call after setting program)
     void rcompute_set_uniform_int(rcompute *c, const char *name, int value);
     void rcompute_set_uniform_uint(rcompute *c, const char *name, unsigned int value);
@@ -57,6 +175,22 @@ extern "C"
     void rcompute_set_uniform_vec3(rcompute *c, const char *name, float x, float y, float z);
     void rcompute_set_uniform_vec4(rcompute *c, const char *name, float x, float y, float z, float w);
     void rcompute_set_uniform_mat4(rcompute *c, const char *name, const float *matrix);
+    void rcompute_set_uniform_float_array(rcompute *c, const char *name, const float *values, int count);
+
+    // Parameter blocks: upload a C struct matching a std140 uniform block and bind it
+    // to `binding` with a single glBindBufferRange (ring-allocated, no stalls)
+    void rcompute_set_params(rcompute *c, GLuint binding, const void *data, GLsizeiptr size);
+
+    // Pre-resolved uniforms: look the name up once, then set by location (-1 = not found)
+    GLint rcompute_uniform_location(rcompute *c, const char *name);
+    void rcompute_set_uniform_int_at(rcompute *c, GLint loc, int value);
+    void rcompute_set_uniform_uint_at(rcompute *c, GLint loc, unsigned int value);
+    void rcompute_set_uniform_float_at(rcompute *c, GLint loc, float value);
+    void rcompute_set_uniform_vec2_at(rcompute *c, GLint loc, float x, float y);
+    void rcompute_set_uniform_vec3_at(rcompute *c, GLint loc, float x, float y, float z);
+    void rcompute_set_uniform_vec4_at(rcompute *c, GLint loc, float x, float y, float z, float w);
+    void rcompute_set_uniform_mat4_at(rcompute *c, GLint loc, const float *matrix);
+    void rcompute_set_uniform_float_array_at(rcompute *c, GLint loc, const float *values, int count);
 
     // create SSBO of N bytes
     GLuint rcompute_buffer(GLsizeiptr size, const void *data);
@@ -64,9 +198,15 @@ extern "C"
     // create SSBO with specific usage hint
     GLuint rcompute_buffer_ex(GLsizeiptr size, const void *data, rcompute_usage usage);
 
-    // create zero-initialized SSBO
+    // create zero-initialized SSBO (cleared on the GPU)
     GLuint rcompute_buffer_zero(GLsizeiptr size);
 
+    // GPU-side clear / fill / copy; nothing crosses the bus. size 0 = to the end of the buffer
+    void rcompute_buffer_clear(GLuint buf, GLsizeiptr offset, GLsizeiptr size);
+    // pattern_size: 1, 2, 4, 8, 12 or 16 bytes; offset and size must be multiples of it
+    void rcompute_buffer_fill(GLuint buf, GLsizeiptr offset, GLsizeiptr size, const void *pattern, int pattern_size);
+    void rcompute_buffer_copy(GLuint src, GLsizeiptr src_offset, GLuint dst, GLsizeiptr dst_offset, GLsizeiptr size);
+
     // update existing buffer data
     void rcompute_buffer_write(GLuint buf, GLsizeiptr offset, GLsizeiptr size, const void *data);
 
@@ -80,20 +220,165 @@ extern "C"
     void *rcompute_buffer_map(GLuint buf, GLenum access);
     void rcompute_buffer_unmap(GLuint buf);
 
-    // async buffer operations
+    // Sub-allocating SSBO pool: slices of a few large buffers. Slice handles (RCOMPUTE_SLICE_BIT set)
+    // work with rcompute_buffer_write/bind/size/map/unmap/destroy, rcompute_read and readbacks;
+    // binding uses glBindBufferRange. Don't pass them to raw GL calls.
+#define RCOMPUTE_SLICE_BIT 0x80000000u
+    typedef struct rcompute_pool rcompute_pool;
+
+    typedef struct
+    {
+        int blocks;
+        int allocations;
+        long long reserved_bytes; // GPU memory held by the pool
+        long long used_bytes;     // bytes handed out (after alignment)
+        long long free_bytes;
+        long long largest_free;   // biggest single allocation that fits without a new block
+        int free_ranges;
+        float fragmentation;      // 1 - largest_free / free_bytes (0 = one contiguous hole)
+    } rcompute_pool_stats;
+
+    // blocks of block_size bytes are created on demand
+    rcompute_pool *rcompute_pool_create(GLsizeiptr block_size);
+    GLuint rcompute_pool_alloc(rcompute_pool *pool, GLsizeiptr size, const void *data);
+    void rcompute_pool_free(rcompute_pool *pool, GLuint slice);
+    void rcompute_pool_get_stats(rcompute_pool *pool, rcompute_pool_stats *stats);
+    void rcompute_pool_destroy(rcompute_pool *pool);
+
+    // Transient arena: scratch SSBO ranges and textures live for one begin/end iteration and are
+    // recycled in bulk once that iteration's fence signals. Handles are owned by the arena;
+    // don't destroy them. Overflowing a frame spills into a new buffer, and the frame is
+    // resized to fit on its next use, so steady-state loops perform no GL allocations.
+#ifndef RCOMPUTE_ARENA_FRAMES
+#define RCOMPUTE_ARENA_FRAMES 2
+#endif
+    typedef struct rcompute_arena rcompute_arena;
+
+    typedef struct
+    {
+        long long gl_allocations; // buffers and textures created since rcompute_arena_create
+        long long frame_bytes;    // bytes handed out in the current iteration
+        long long reserved_bytes; // buffer memory held across all frames
+        int textures;             // textures held across all frames
+    } rcompute_arena_stats;
+
+    rcompute_arena *rcompute_arena_create(GLsizeiptr frame_size);
+    void rcompute_arena_begin(rcompute_arena *a);
+    GLuint rcompute_arena_buffer(rcompute_arena *a, GLsizeiptr size);
+    GLuint rcompute_arena_texture_2d(rcompute_arena *a, int width, int height, GLenum format);
+    void rcompute_arena_end(rcompute_arena *a);
+    void rcompute_arena_get_stats(rcompute_arena *a, rcompute_arena_stats *stats);
+    void rcompute_arena_destroy(rcompute_arena *a);
+
+    // Ping-pong pair for iterative kernels: read the front object, write the back one, then swap.
+    // swap() rebinds both to their fixed bindings; the next dispatch infers the barrier it needs.
+    typedef struct
+    {
+        GLuint objects[2];
+        int front;            // index of the object kernels read from
+        int is_texture;
+        GLenum format;        // textures: image format
+        GLuint read_binding;  // SSBO binding or image unit
+        GLuint write_binding;
+    } rcompute_pingpong;
+
+    // both buffers start with data (may be NULL)
+    int rcompute_pingpong_buffers(rcompute_pingpong *pp, GLsizeiptr size, const void *data, GLuint read_binding, GLuint write_binding);
+    // both images start with data (may be NULL); read side is bound GL_READ_ONLY, write side GL_WRITE_ONLY
+    int rcompute_pingpong_textures(rcompute_pingpong *pp, int width, int height, GLenum format, const void *data,
+                                   GLuint read_unit, GLuint write_unit);
+    void rcompute_pingpong_bind(rcompute_pingpong *pp);
+    void rcompute_pingpong_swap(rcompute_pingpong *pp);
+    GLuint rcompute_pingpong_front(const rcompute_pingpong *pp); // latest results after a swap
+    GLuint rcompute_pingpong_back(const rcompute_pingpong *pp);
+    void rcompute_pingpong_destroy(rcompute_pingpong *pp);
+
+    // Streaming upload ring (GL 4.4 glBufferStorage, persistently mapped)
+#ifndef RCOMPUTE_RING_SEGMENTS
+#define RCOMPUTE_RING_SEGMENTS 4
+#endif
+    typedef struct
+    {
+        GLuint buffer;
+        GLsizeiptr size;
+        GLsizeiptr head;        // next free byte
+        unsigned char *ptr;     // persistent CPU mapping
+        int coherent;           // 0 = writes must be published with rcompute_ring_flush
+        int current_segment;
+        unsigned int touched;   // segments written since the last rcompute_ring_fence
+        GLsync fences[RCOMPUTE_RING_SEGMENTS];
+    } rcompute_ring;
+
+    // create a ring of `size` bytes; coherent=0 selects the explicit-flush variant
+    int rcompute_ring_create(rcompute_ring *r, GLsizeiptr size, int coherent);
+
+    // reserve `size` bytes (align <= 0: SSBO offset alignment); write through the returned
+    // pointer. Blocks only if the GPU is still reading that segment from the previous lap.
+    void *rcompute_ring_alloc(rcompute_ring *r, GLsizeiptr size, GLsizeiptr align, GLsizeiptr *offset);
+
+    // publish CPU writes (explicit-flush rings only; no-op for coherent rings)
+    void rcompute_ring_flush(rcompute_ring *r, GLsizeiptr offset, GLsizeiptr size);
+
+    // consume ring data: GPU copy into a buffer, or bind the range as an SSBO directly
+    void rcompute_ring_copy(rcompute_ring *r, GLsizeiptr offset, GLuint dst, GLsizeiptr dst_offset, GLsizeiptr size);
+    void rcompute_ring_bind(rcompute_ring *r, GLuint binding, GLsizeiptr offset, GLsizeiptr size);
+
+    // fence the segments used since the last call; call once per frame after the consuming commands
+    void rcompute_ring_fence(rcompute_ring *r);
+
+    void rcompute_ring_destroy(rcompute_ring *r);
+
+    // async buffer operations (data is valid after rcompute_wait_async)
     void rcompute_read_async(GLuint buf, void *data, size_t size, size_t offset);
     void rcompute_wait_async();
 
+    // Readback tickets: copy into a staging buffer on the GPU and fence it; many can be in flight
+    typedef unsigned int rcompute_ticket; // 0 = invalid
+    rcompute_ticket rcompute_readback(GLuint buf, GLsizeiptr offset, GLsizeiptr size);
+
+    // non-blocking: 1 if the ticket's data has arrived
+    int rcompute_readback_ready(rcompute_ticket ticket);
+
+    // block until ready, copy into out (NULL discards) and release the ticket; returns 1 on success
+    int rcompute_readback_wait(rcompute_ticket ticket, void *out);
+
     // destroy a buffer
     void rcompute_buffer_destroy(GLuint buf);
 
+    // Object registry: sizes/bounds are answered from memory, not the driver
+    typedef struct
+    {
+        long long live_bytes;
+        long long peak_bytes;
+        int live_buffers;
+        int live_textures;
+    } rcompute_memory_stats;
+
+    // attach a debug label (also visible in GL debuggers via glObjectLabel)
+    void rcompute_buffer_label(GLuint buf, const char *label);
+    void rcompute_texture_label(GLuint tex, const char *label);
+
+    void rcompute_get_memory_stats(rcompute_memory_stats *stats);
+
+    // print every live buffer/texture with size, label and creation site
+    void rcompute_memory_report(void);
+
+    // creation with an explicit site; #define RCOMPUTE_TRACK_ALLOCATIONS routes the
+    // plain creation calls through these with __FILE__/__LINE__
+    GLuint rcompute_buffer_tracked(GLsizeiptr size, const void *data, rcompute_usage usage, const char *file, int line);
+    GLuint rcompute_buffer_zero_tracked(GLsizeiptr size, const char *file, int line);
+    GLuint rcompute_texture_2d_tracked(int width, int height, GLenum format, const void *data, const char *file, int line);
+    GLuint rcompute_texture_3d_tracked(int width, int height, int depth, GLenum format, const void *data, const char *file, int line);
+
     // Texture operations
     GLuint rcompute_texture_2d(int width, int height, GLenum format, const void *data);
     GLuint rcompute_texture_3d(int width, int height, int depth, GLenum format, const void *data);
     void rcompute_texture_bind(GLuint tex, GLuint unit, GLenum format);
     void rcompute_texture_destroy(GLuint tex);
 
-    // run the compute shader: dispatch nx,ny,nz
+    // run the compute shader: dispatch nx,ny,nz. Memory barriers are inferred: buffers and images
+    // the program writes (per reflection + readonly/writeonly) are marked dirty, and only a later
+    // access through rcompute that actually touches a dirty object emits the bits it needs
     void rcompute_run(rcompute *c, int nx, int ny, int nz);
 
     // convenience: dispatch 1D compute (nx, 1, 1)
@@ -102,6 +387,51 @@ extern "C"
     // convenience: dispatch 2D compute (nx, ny, 1)
     void rcompute_dispatch_2d(rcompute *c, int nx, int ny);
 
+    // dispatch by element count: groups = ceil(count / local size) using the program's
+    // GL_COMPUTE_WORK_GROUP_SIZE. The kernel must still bounds-check the last partial group.
+    void rcompute_dispatch_items_1d(rcompute *c, int count_x);
+    void rcompute_dispatch_items_2d(rcompute *c, int count_x, int count_y);
+    void rcompute_dispatch_items_3d(rcompute *c, int count_x, int count_y, int count_z);
+
+    // dispatch with group counts read by the GPU from buf at offset: three uints (nx, ny, nz),
+    // e.g. written by a previous dispatch. offset must be a multiple of 4.
+    void rcompute_run_indirect(rcompute *c, GLuint buf, GLintptr offset);
+
+    // GPU-side helper: reads the uint count at count_offset in count_buf and writes indirect
+    // arguments (ceil(count / group_size), 1, 1) at args_offset in args_buf. No CPU round trip.
+    // Borrows the two highest SSBO bindings (GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS - 2 and - 1)
+    // for one dispatch; whatever was bound there, and the current program, are restored after.
+    void rcompute_indirect_args(rcompute *c, GLuint count_buf, GLintptr count_offset, GLuint args_buf,
+                                GLintptr args_offset, GLuint group_size);
+
+    // Recorded command lists: capture a fixed program/bind/uniform/dispatch/barrier sequence once
+    // and replay it. Handles, uniform locations and slice ranges are resolved while recording;
+    // replay issues raw GL calls with no validation. Redundant program/bind changes and adjacent
+    // barriers are collapsed, and a uniform that is the only writer of its location is only
+    // re-sent after rcompute_cmdlist_set_*. Uniform recorders return a parameter id (-1 if the
+    // uniform doesn't exist) that can be changed between replays; everything else is frozen.
+    typedef struct rcompute_cmdlist rcompute_cmdlist;
+
+    rcompute_cmdlist *rcompute_cmdlist_create(void);
+    void rcompute_cmdlist_program(rcompute_cmdlist *cl, GLuint program);
+    void rcompute_cmdlist_buffer(rcompute_cmdlist *cl, GLuint buf, GLuint binding);
+    void rcompute_cmdlist_texture(rcompute_cmdlist *cl, GLuint tex, GLuint unit, GLenum format);
+    int rcompute_cmdlist_uniform_int(rcompute_cmdlist *cl, const char *name, int value);
+    int rcompute_cmdlist_uniform_uint(rcompute_cmdlist *cl, const char *name, unsigned int value);
+    int rcompute_cmdlist_uniform_float(rcompute_cmdlist *cl, const char *name, float value);
+    int rcompute_cmdlist_uniform_vec4(rcompute_cmdlist *cl, const char *name, float x, float y, float z, float w);
+    // barriers are inferred at replay exactly as for rcompute_run
+    void rcompute_cmdlist_dispatch(rcompute_cmdlist *cl, int nx, int ny, int nz);
+    void rcompute_cmdlist_barrier(rcompute_cmdlist *cl, GLbitfield barriers);
+    void rcompute_cmdlist_set_int(rcompute_cmdlist *cl, int param, int value);
+    void rcompute_cmdlist_set_uint(rcompute_cmdlist *cl, int param, unsigned int value);
+    void rcompute_cmdlist_set_float(rcompute_cmdlist *cl, int param, float value);
+    void rcompute_cmdlist_set_vec4(rcompute_cmdlist *cl, int param, float x, float y, float z, float w);
+    // resend every uniform on the next replay (after changing them outside the list)
+    void rcompute_cmdlist_invalidate(rcompute_cmdlist *cl);
+    void rcompute_cmdlist_replay(rcompute *c, rcompute_cmdlist *cl, int times);
+    void rcompute_cmdlist_destroy(rcompute_cmdlist *cl);
+
     // read back from SSBO
     void rcompute_read(GLuint buf, void *out, GLsizeiptr size);
 
@@ -109,15 +439,72 @@ extern "C"
     void *rcompute_buffer_map(GLuint buf, GLenum access);
     void rcompute_buffer_unmap(GLuint buf);
 
-    // Memory barriers
+    // Memory barriers: only needed before raw GL access (e.g. glGetTexImage) to shader output
     void rcompute_barrier(GLenum barriers);
     void rcompute_barrier_all(void);
 
     // GPU timing/profiling
     void rcompute_timer_begin(void);
-    double rcompute_timer_end(void); // returns milliseconds
+    double rcompute_timer_end(void); // returns milliseconds; waits for the GPU
     void rcompute_timer_destroy(void);
 
+    // Pooled timer scopes: labeled, nestable, never wait for the GPU. Each scope records a
+    // GL_TIMESTAMP pair; results are picked up once GL_QUERY_RESULT_AVAILABLE says so.
+#ifndef RCOMPUTE_TIMER_WINDOW
+#define RCOMPUTE_TIMER_WINDOW 64
+#endif
+    typedef struct
+    {
+        char label[48];   // a copy, valid after later pushes and rcompute_timer_destroy
+        int depth;        // nesting depth, 0 = outermost
+        long long count;  // samples collected
+        double last_ms;
+        double avg_ms;    // over the last RCOMPUTE_TIMER_WINDOW samples
+        double min_ms;    // same window
+        double max_ms;
+        double total_ms;  // every sample
+    } rcompute_timer_stats;
+    void rcompute_timer_push(const char *label);
+    void rcompute_timer_pop(void);
+    // gathers finished scopes (wait = 1: all of them, blocking); returns how many
+    int rcompute_timer_collect(int wait);
+    // 1 and fills out if the label has samples
+    int rcompute_timer_stats_get(const char *label, rcompute_timer_stats *out);
+    void rcompute_timer_report(void);
+
+    // Opt-in profiler: every dispatch, upload, readback, copy and barrier records GL_TIMESTAMP
+    // queries and CPU timestamps. The timeline is written as Chrome trace-event JSON
+    // (chrome://tracing, Perfetto): one track for CPU submission, one for GPU execution.
+    // Past RCOMPUTE_PROFILER_MAX_EVENTS newer events are dropped until the next reset.
+#ifndef RCOMPUTE_PROFILER_MAX_EVENTS
+#define RCOMPUTE_PROFILER_MAX_EVENTS (1 << 18)
+#endif
+    void rcompute_profiler_enable(int enable);
+    int rcompute_profiler_write_trace(const char *path); // waits for pending queries; 0 on failure
+    void rcompute_profiler_reset(void);                  // drops recorded events
+
+    // name a program in profiles and GL debuggers; rcompute_compile_file uses the file path
+    void rcompute_program_label(GLuint program, const char *label);
+
+    // Per-program throughput: bytes of the bound buffers/images each dispatch can read or write,
+    // divided by its measured GPU time. Bytes assume every bound resource is touched in full.
+    typedef struct
+    {
+        char label[48];             // copy of the program label, "" if none
+        long long dispatches;       // measured dispatches
+        long long invocations;      // indirect dispatches count as 0
+        long long bytes_read;
+        long long bytes_written;
+        double gpu_ms;
+        double gb_per_s;            // (bytes_read + bytes_written) / GPU time
+        double invocations_per_s;
+    } rcompute_dispatch_stats;
+    void rcompute_dispatch_stats_enable(int enable); // debug mode also measures and logs each dispatch
+    // waits for outstanding measurements; 0 if the program has none
+    int rcompute_dispatch_stats_get(GLuint program, rcompute_dispatch_stats *out);
+    void rcompute_dispatch_stats_report(void);
+    void rcompute_dispatch_stats_reset(void);
+
     // Query compute limits
     void rcompute_get_limits(rcompute *c, int *max_work_group_count_x,
                              int *max_work_group_count_y, int *max_work_group_count_z,
@@ -149,21 +536,241 @@ extern "C"
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <time.h>
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifdef RCOMPUTE_USE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
 
 // Global error state
 static char rcompute__last_error[512] = {0};
+#ifndef RCOMPUTE_NO_GLFW
 static int rcompute__glfw_initialized = 0;
+#endif
 
 // GPU timing state
 static GLuint rcompute__query_id = 0;
 static int rcompute__query_available = 0;
 
-// Async read state
-static GLsync rcompute__sync = NULL;
+// Pooled timer scopes
+#define RCOMPUTE__TIMER_DEPTH 32
+typedef struct
+{
+    GLuint begin; // GL_TIMESTAMP queries
+    GLuint end;
+    int stat;     // index into rcompute__timer_stats
+} rcompute__timer_scope;
+typedef struct
+{
+    char label[48];
+    int depth;
+    long long count;
+    double last_ms;
+    double total_ms;
+    double window[RCOMPUTE_TIMER_WINDOW];
+} rcompute__timer_stat;
+static GLuint *rcompute__timer_free = NULL; // recycled query names
+static int rcompute__timer_free_count = 0;
+static int rcompute__timer_free_cap = 0;
+static rcompute__timer_scope *rcompute__timer_pending = NULL; // ended, oldest first
+static int rcompute__timer_pending_count = 0;
+static int rcompute__timer_pending_cap = 0;
+static rcompute__timer_scope rcompute__timer_stack[RCOMPUTE__TIMER_DEPTH];
+static int rcompute__timer_depth = 0;
+static rcompute__timer_stat *rcompute__timer_stats = NULL;
+static int rcompute__timer_stat_count = 0;
+static int rcompute__timer_stat_cap = 0;
+
+// Profiler: one event per GL operation while enabled
+typedef struct
+{
+    const char *cat;      // "dispatch", "upload", "readback", "copy", "barrier"
+    char name[48];
+    GLuint query[2];      // GL_TIMESTAMP before and after, 0 once resolved
+    GLuint64 gpu[2];      // ns
+    long long cpu[2];     // ns
+    GLuint groups[3];     // dispatches
+    int indirect;
+    long long bytes;      // transfers; bytes read by dispatches
+    long long bytes_written; // dispatches
+    GLbitfield barriers;  // barriers
+} rcompute__prof_event;
+static int rcompute__prof_enabled = 0;
+static rcompute__prof_event *rcompute__prof_events = NULL;
+static int rcompute__prof_count = 0;
+static int rcompute__prof_cap = 0;
+static int rcompute__prof_resolved = 0; // events before this have their GPU times
+static long long rcompute__prof_dropped = 0; // events refused at RCOMPUTE_PROFILER_MAX_EVENTS
+static GLint64 rcompute__prof_gpu_base = 0;
+static long long rcompute__prof_cpu_base = 0;
+
+// Throughput accounting: timestamp pairs around dispatches, resolved oldest first
+typedef struct
+{
+    GLuint query[2];
+    GLuint program;
+    GLuint groups[3];
+    long long invocations;
+    long long bytes_read;
+    long long bytes_written;
+} rcompute__dispatch_sample;
+static int rcompute__stats_enabled = 0;
+static rcompute__dispatch_sample *rcompute__samples = NULL;
+static int rcompute__sample_count = 0;
+static int rcompute__sample_cap = 0;
+
+// Async readback state: one staging buffer + fence per in-flight ticket
+typedef struct
+{
+    GLuint staging;
+    GLsizeiptr capacity;
+    void *mapped;        // persistent mapping (NULL when glBufferStorage is unavailable)
+    GLsizeiptr size;
+    GLsync fence;        // NULL = slot free
+    unsigned int gen;    // bumped on release so stale tickets are rejected
+    void *legacy_dest;   // destination for rcompute_read_async
+} rcompute__readback;
+static rcompute__readback *rcompute__readbacks = NULL;
+static int rcompute__readback_count = 0;
+static int rcompute__buffer_storage = -1; // -1 = not queried yet
+
+// Program binary cache state
+static char rcompute__cache_dir[512] = {0};
+static int rcompute__cache_dir_set = 0;
+static int rcompute__cache_hits = 0;
+static int rcompute__cache_misses = 0;
+
+// Programs submitted through rcompute_compile_async that haven't been collected yet
+typedef struct
+{
+    GLuint program;
+    unsigned long long cache_key; // 0 = don't store in cache
+} rcompute__pending_program;
+static rcompute__pending_program *rcompute__pending = NULL;
+static int rcompute__pending_count = 0;
+static int rcompute__pending_cap = 0;
+static int rcompute__parallel_compile = -1; // -1 = not queried yet
+
+// Variant cache: open-addressed table keyed by source hash + normalized defines
+typedef struct
+{
+    unsigned long long key;     // 0 = empty slot
+    unsigned long long src_hash;
+    char *defines;              // normalized, '\n'-joined
+    GLuint program;
+    int refcount;
+} rcompute__variant;
+static rcompute__variant *rcompute__variants = NULL;
+static int rcompute__variant_count = 0;
+static int rcompute__variant_cap = 0; // power of two
+
+// Program registry: per-program uniform location tables
+typedef struct
+{
+    unsigned long long hash;
+    char *name; // NULL = empty slot
+    GLint location;
+} rcompute__uniform_slot;
+
+// SSBO block or image uniform a program accesses, for barrier inference
+#define RCOMPUTE__ACCESS_READ 1
+#define RCOMPUTE__ACCESS_WRITE 2
+typedef struct
+{
+    GLuint binding; // SSBO binding point or image unit
+    int image;
+    int access;     // RCOMPUTE__ACCESS_* from readonly/writeonly; both when unknown
+    char name[64];  // block or image uniform name, without [N]
+    GLenum type;    // images: GL image type
+    GLenum format;  // images: layout format from the source, 0 = unknown
+    GLint min_size; // blocks: GL_BUFFER_DATA_SIZE
+    GLint block_index;  // blocks: GL_SHADER_STORAGE_BLOCK index, -1 for images
+    GLint array_offset; // blocks: offset and stride of a trailing unsized array (stride 0 = none)
+    GLint array_stride;
+} rcompute__resource_use;
+
+typedef struct
+{
+    GLuint program;
+    rcompute__uniform_slot *uniforms; // open-addressed, power-of-two capacity
+    int uniform_count;
+    int uniform_cap;
+    rcompute__resource_use *resources;
+    int resource_count;
+    int shared_bytes;                 // from the source, -1 = unknown
+    GLint local_size[3];              // GL_COMPUTE_WORK_GROUP_SIZE
+    GLint group_offset_location;      // "rcompute_group_offset" uvec3, -1 = not declared
+    GLuint group_offset[3];           // value last sent to it
+    char label[48];                   // rcompute_program_label, shown by the profiler
+    long long stat_dispatches;        // throughput accounting
+    long long stat_invocations;
+    long long stat_bytes_read;
+    long long stat_bytes_written;
+    double stat_gpu_ms;
+    rcompute_reflection *reflection;  // built on first rcompute_reflect
+} rcompute__program_info;
+static rcompute__program_info *rcompute__programs = NULL;
+static int rcompute__program_count = 0;
+static int rcompute__program_cap = 0;
+static int rcompute__program_last = -1;
+
+// Object registry: buffers and textures created through rcompute
+#define RCOMPUTE__OBJ_BUFFER 0
+#define RCOMPUTE__OBJ_TEXTURE 1
+#define RCOMPUTE__OBJ_SLICE 2
+#define RCOMPUTE__USAGE_INTERNAL -1
+
+typedef struct
+{
+    GLuint name; // 0 = empty slot
+    int kind;
+    GLsizeiptr size;
+    int usage;   // rcompute_usage, or RCOMPUTE__USAGE_INTERNAL
+    const char *file;
+    int line;
+    char label[48];
+    GLuint parent;        // slices: pool block or arena buffer
+    GLsizeiptr offset;    // slices: offset inside parent
+    rcompute_pool *pool;  // slices: owning pool, NULL for arena slices
+    unsigned long long write_serial; // dispatch that last wrote it (barrier inference)
+    int persistent;       // persistently mapped: shader writes need a client-mapped barrier
+} rcompute__object;
+static rcompute__object *rcompute__objects = NULL;
+static int rcompute__object_count = 0;
+static int rcompute__object_cap = 0; // power of two
+static long long rcompute__live_bytes = 0;
+static long long rcompute__peak_bytes = 0;
+static GLuint rcompute__next_slice = 1;
+
+// Barrier inference: what is bound where, and which dispatch wrote what. A consumer needs
+// barrier bit B on an object when its write serial is newer than the last time B was issued.
+#define RCOMPUTE__MAX_BINDINGS 128
+static GLuint rcompute__ssbo_bound[RCOMPUTE__MAX_BINDINGS];  // GL buffer per binding, 0 = unknown
+static GLuint rcompute__image_bound[RCOMPUTE__MAX_BINDINGS]; // texture per image unit, 0 = unknown
+static GLsizeiptr rcompute__ssbo_bound_bytes[RCOMPUTE__MAX_BINDINGS]; // bound range, 0 = whole buffer
+static unsigned long long rcompute__serial = 0;              // bumped per dispatch
+static unsigned long long rcompute__last_write = 0;          // newest write anywhere
+static unsigned long long rcompute__unknown_write = 0;       // newest write to an untracked object
+static unsigned long long rcompute__barrier_serial[32];      // per barrier bit: serial when last issued
+
+// GL_MAX_COMPUTE_WORK_GROUP_COUNT per axis, queried on first dispatch; larger grids are split
+static GLuint rcompute__group_limit[3] = {0, 0, 0};
+
+// count -> indirect arguments kernel, compiled on first rcompute_indirect_args
+static GLuint rcompute__indirect_program = 0;
+static GLint rcompute__indirect_binding = 0; // count block; args block is the next one
 
 // Debug mode
 static int rcompute__debug = 0;
-static GLsync rcompute__async_sync = NULL;
 
 // error printing and tracking
 static void rcompute__err(const char *txt)
@@ -201,677 +808,4797 @@ void rcompute_set_debug(int enable)
 }
 
 // ---------------------------------
-// Version check
+// Hashing
 // ---------------------------------
-int rcompute_check_version(int required_major, int required_minor)
+static unsigned long long rcompute__fnv1a(unsigned long long h, const void *data, size_t len)
 {
-    const GLubyte *version = glGetString(GL_VERSION);
-    if (!version) return 0;
-    
-    int major = 0, minor = 0;
-    sscanf((const char *)version, "%d.%d", &major, &minor);
-    
-    if (major > required_major) return 1;
-    if (major == required_major && minor >= required_minor) return 1;
-    return 0;
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < len; i++)
+    {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static unsigned long long rcompute__fnv1a_str(unsigned long long h, const char *str)
+{
+    // include the terminator so "ab"+"c" and "a"+"bc" differ
+    return str ? rcompute__fnv1a(h, str, strlen(str) + 1) : rcompute__fnv1a(h, "", 1);
 }
 
 // ---------------------------------
-// create invisible 1×1 GLFW window
+// Program registry (per-program metadata)
 // ---------------------------------
-int rcompute_init(rcompute *c, int gl_major, int gl_minor)
+static int rcompute__program_find(GLuint program)
 {
-    if (!c)
-        return 0;
-
-    // Initialize to safe state
-    c->window = NULL;
-    c->program = 0;
-    c->last_program = 0;
-
-    if (!rcompute__glfw_initialized)
-    {
-        if (!glfwInit())
-            return 0;
-        rcompute__glfw_initialized = 1;
-    }
-
-    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, gl_major);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, gl_minor);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    c->window = glfwCreateWindow(1, 1, "", NULL, NULL);
-    if (!c->window)
+    if (program == 0)
+        return -1;
+    if (rcompute__program_last >= 0 && rcompute__program_last < rcompute__program_count &&
+        rcompute__programs[rcompute__program_last].program == program)
+        return rcompute__program_last;
+    for (int i = 0; i < rcompute__program_count; i++)
     {
-        glfwTerminate();
-        return 0;
+        if (rcompute__programs[i].program == program)
+        {
+            rcompute__program_last = i;
+            return i;
+        }
     }
-
-    glfwMakeContextCurrent(c->window);
-    if (glewInit() != GLEW_OK)
-        return 0;
-
-    rcompute__debug_log("Initialized OpenGL %d.%d context", gl_major, gl_minor);
-    return 1;
+    return -1;
 }
 
-// ---------------------------------
-// compile compute shader
-// ---------------------------------
-GLuint rcompute_compile(const char *src)
+static void rcompute__uniform_insert(rcompute__program_info *info, const char *name, GLint location)
 {
-    if (!src)
+    if ((info->uniform_count + 1) * 10 > info->uniform_cap * 7)
     {
-        rcompute__err("Shader source is NULL");
-        return 0;
+        int new_cap = info->uniform_cap ? info->uniform_cap * 2 : 32;
+        rcompute__uniform_slot *slots = (rcompute__uniform_slot *)calloc(new_cap, sizeof(rcompute__uniform_slot));
+        if (!slots)
+            return;
+        for (int i = 0; i < info->uniform_cap; i++)
+        {
+            if (!info->uniforms[i].name)
+                continue;
+            int j = (int)(info->uniforms[i].hash & (new_cap - 1));
+            while (slots[j].name)
+                j = (j + 1) & (new_cap - 1);
+            slots[j] = info->uniforms[i];
+        }
+        free(info->uniforms);
+        info->uniforms = slots;
+        info->uniform_cap = new_cap;
     }
 
-    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
-    glShaderSource(shader, 1, &src, 0);
-    glCompileShader(shader);
-
-    GLint ok;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
-    if (!ok)
+    unsigned long long h = rcompute__fnv1a_str(14695981039346656037ULL, name);
+    int mask = info->uniform_cap - 1;
+    int i = (int)(h & mask);
+    while (info->uniforms[i].name)
     {
-        char log[4096];
-        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
-        rcompute__err(log);
-        return 0;
+        if (info->uniforms[i].hash == h && strcmp(info->uniforms[i].name, name) == 0)
+        {
+            info->uniforms[i].location = location;
+            return;
+        }
+        i = (i + 1) & mask;
     }
 
-    GLuint prog = glCreateProgram();
-    glAttachShader(prog, shader);
-    glLinkProgram(prog);
-    glDeleteShader(shader);
+    size_t len = strlen(name);
+    char *copy = (char *)malloc(len + 1);
+    if (!copy)
+        return;
+    memcpy(copy, name, len + 1);
+    info->uniforms[i].hash = h;
+    info->uniforms[i].name = copy;
+    info->uniforms[i].location = location;
+    info->uniform_count++;
+}
 
-    glGetProgramiv(prog, GL_LINK_STATUS, &ok);
-    if (!ok)
-    {
-        char log[4096];
-        glGetProgramInfoLog(prog, sizeof(log), NULL, log);
-        rcompute__err(log);
-        return 0;
-    }
+static void rcompute__resource_add(rcompute__program_info *info, GLuint binding, int image, const char *name)
+{
+    rcompute__resource_use *r = (rcompute__resource_use *)realloc(
+        info->resources, (info->resource_count + 1) * sizeof(rcompute__resource_use));
+    if (!r)
+        return;
+    info->resources = r;
+
+    rcompute__resource_use *use = &info->resources[info->resource_count++];
+    use->binding = binding;
+    use->image = image;
+    use->access = RCOMPUTE__ACCESS_READ | RCOMPUTE__ACCESS_WRITE;
+    use->block_index = -1;
+    snprintf(use->name, sizeof(use->name), "%s", name);
+    char *bracket = strchr(use->name, '[');
+    if (bracket)
+        *bracket = '\0';
+}
 
-    return prog;
+static int rcompute__is_ident(char ch)
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
 }
 
-// ---------------------------------
-// compile with preprocessor defines
-// ---------------------------------
-GLuint rcompute_compile_with_defines(const char *src, const char **defines, int count)
+// whole-word search for word in [begin, end), ignoring // comments
+static int rcompute__span_has_word(const char *begin, const char *end, const char *word)
 {
-    if (!src)
+    size_t len = strlen(word);
+    for (const char *p = begin; p + len <= end; p++)
     {
-        rcompute__err("Shader source is NULL");
-        return 0;
+        if (p[0] == '/' && p + 1 < end && p[1] == '/')
+        {
+            while (p < end && *p != '\n')
+                p++;
+            continue;
+        }
+        if (strncmp(p, word, len) == 0 && (p == begin || !rcompute__is_ident(p[-1])) &&
+            (p + len == end || !rcompute__is_ident(p[len])))
+            return 1;
     }
+    return 0;
+}
 
-    // Calculate total length needed
-    size_t total_len = strlen(src) + 1;
-    for (int i = 0; i < count; i++)
+static const struct
+{
+    const char *name;
+    GLenum format;
+} rcompute__image_formats[] = {
+    {"rgba32f", GL_RGBA32F}, {"rgba16f", GL_RGBA16F}, {"rg32f", GL_RG32F}, {"rg16f", GL_RG16F},
+    {"r11f_g11f_b10f", GL_R11F_G11F_B10F}, {"r32f", GL_R32F}, {"r16f", GL_R16F},
+    {"rgba16", GL_RGBA16}, {"rgb10_a2", GL_RGB10_A2}, {"rgba8", GL_RGBA8}, {"rg16", GL_RG16},
+    {"rg8", GL_RG8}, {"r16", GL_R16}, {"r8", GL_R8},
+    {"rgba16_snorm", GL_RGBA16_SNORM}, {"rgba8_snorm", GL_RGBA8_SNORM}, {"rg16_snorm", GL_RG16_SNORM},
+    {"rg8_snorm", GL_RG8_SNORM}, {"r16_snorm", GL_R16_SNORM}, {"r8_snorm", GL_R8_SNORM},
+    {"rgba32i", GL_RGBA32I}, {"rgba16i", GL_RGBA16I}, {"rgba8i", GL_RGBA8I}, {"rg32i", GL_RG32I},
+    {"rg16i", GL_RG16I}, {"rg8i", GL_RG8I}, {"r32i", GL_R32I}, {"r16i", GL_R16I}, {"r8i", GL_R8I},
+    {"rgba32ui", GL_RGBA32UI}, {"rgba16ui", GL_RGBA16UI}, {"rgb10_a2ui", GL_RGB10_A2UI},
+    {"rgba8ui", GL_RGBA8UI}, {"rg32ui", GL_RG32UI}, {"rg16ui", GL_RG16UI}, {"rg8ui", GL_RG8UI},
+    {"r32ui", GL_R32UI}, {"r16ui", GL_R16UI}, {"r8ui", GL_R8UI},
+    {NULL, 0}};
+
+// bytes of a basic GLSL type, 0 for anything else (structs etc.)
+static int rcompute__glsl_type_size(const char *type, size_t len)
+{
+    static const struct
     {
-        if (defines[i])
-            total_len += strlen("#define ") + strlen(defines[i]) + 2; // +2 for newline
-    }
+        const char *name;
+        int size;
+    } types[] = {{"float", 4}, {"int", 4}, {"uint", 4}, {"bool", 4}, {"double", 8},
+                 {"vec2", 8}, {"vec3", 12}, {"vec4", 16}, {"ivec2", 8}, {"ivec3", 12}, {"ivec4", 16},
+                 {"uvec2", 8}, {"uvec3", 12}, {"uvec4", 16}, {"bvec2", 8}, {"bvec3", 12}, {"bvec4", 16},
+                 {"dvec2", 16}, {"dvec3", 24}, {"dvec4", 32}, {"mat2", 16}, {"mat3", 36}, {"mat4", 64},
+                 {NULL, 0}};
+    for (int i = 0; types[i].name; i++)
+        if (strlen(types[i].name) == len && strncmp(types[i].name, type, len) == 0)
+            return types[i].size;
+    return 0;
+}
 
-    char *modified_src = (char *)malloc(total_len);
-    if (!modified_src)
+// Sum of `shared` declarations with basic types and literal array sizes; -1 if any can't be sized
+static int rcompute__shared_scan(const char *src)
+{
+    int total = 0;
+    for (const char *p = src; (p = strstr(p, "shared")) != NULL; p += 6)
     {
-        rcompute__err("Failed to allocate memory for shader");
-        return 0;
+        if ((p > src && rcompute__is_ident(p[-1])) || rcompute__is_ident(p[6]))
+            continue;
+        const char *line = p;
+        while (line > src && line[-1] != '\n')
+            line--;
+        if (strstr(line, "//") && strstr(line, "//") < p)
+            continue;
+
+        const char *q = p + 6;
+        while (*q == ' ' || *q == '\t')
+            q++;
+        const char *type = q;
+        while (rcompute__is_ident(*q))
+            q++;
+        int size = rcompute__glsl_type_size(type, (size_t)(q - type));
+        if (size == 0)
+            return -1;
+
+        // one or more declarators: name[N][M], name2[K];
+        while (*q && *q != ';')
+        {
+            while (*q == ' ' || *q == '\t' || *q == ',')
+                q++;
+            while (rcompute__is_ident(*q))
+                q++;
+            long count = 1;
+            while (*q == '[')
+            {
+                char *end;
+                long n = strtol(q + 1, &end, 10);
+                if (end == q + 1 || *end != ']')
+                    return -1;
+                count *= n;
+                q = end + 1;
+            }
+            total += (int)(size * count);
+            while (*q == ' ' || *q == '\t')
+                q++;
+            if (*q != ',' && *q != ';')
+                return -1;
+        }
     }
+    return total;
+}
 
-    // Find #version line and insert defines after it
-    const char *version_start = strstr(src, "#version");
-    const char *version_end = version_start ? strstr(version_start, "\n") : NULL;
-    
-    if (version_end)
+// Refine access from the declarations "... readonly buffer Name {" and "... writeonly uniform image2D name"
+static void rcompute__resource_scan(rcompute__program_info *info, const char *src)
+{
+    for (int i = 0; i < info->resource_count; i++)
     {
-        size_t version_len = version_end - src + 1;
-        memcpy(modified_src, src, version_len);
-        char *insert_pos = modified_src + version_len;
+        rcompute__resource_use *use = &info->resources[i];
+        size_t len = strlen(use->name);
+        if (len == 0)
+            continue;
 
-        // Add defines
-        for (int i = 0; i < count; i++)
+        for (const char *p = strstr(src, use->name); p; p = strstr(p + 1, use->name))
         {
-            if (defines[i])
+            if ((p > src && rcompute__is_ident(p[-1])) || rcompute__is_ident(p[len]))
+                continue;
+
+            // previous identifier must be "buffer" (blocks) or the image type (images)
+            const char *q = p;
+            while (q > src && (q[-1] == ' ' || q[-1] == '\t' || q[-1] == '\n' || q[-1] == '\r'))
+                q--;
+            const char *type_end = q;
+            while (q > src && rcompute__is_ident(q[-1]))
+                q--;
+            const char *type = (*q == 'i' || *q == 'u') && q + 1 < type_end && q[1] == 'i' ? q + 1 : q;
+            int match = use->image ? (type_end - type > 5 && strncmp(type, "image", 5) == 0)
+                                   : (type_end - q == 6 && strncmp(q, "buffer", 6) == 0);
+            if (!match)
+                continue;
+
+            const char *decl = q;
+            while (decl > src && decl[-1] != ';' && decl[-1] != '{' && decl[-1] != '}')
+                decl--;
+            int ro = rcompute__span_has_word(decl, q, "readonly");
+            int wo = rcompute__span_has_word(decl, q, "writeonly");
+            if (ro && !wo)
+                use->access = RCOMPUTE__ACCESS_READ;
+            else if (wo && !ro)
+                use->access = RCOMPUTE__ACCESS_WRITE;
+            for (int f = 0; use->image && rcompute__image_formats[f].name; f++)
             {
-                int written = sprintf(insert_pos, "#define %s\n", defines[i]);
-                insert_pos += written;
+                if (rcompute__span_has_word(decl, q, rcompute__image_formats[f].name))
+                {
+                    use->format = rcompute__image_formats[f].format;
+                    break;
+                }
             }
+            break;
         }
+    }
+    info->shared_bytes = rcompute__shared_scan(src);
+}
 
-        // Add rest of source
-        strcpy(insert_pos, version_end + 1);
+// creates the metadata entry for a linked program and fills its uniform table
+static int rcompute__program_register(GLuint program)
+{
+    int index = rcompute__program_find(program);
+    if (index >= 0 || program == 0)
+        return index;
+
+    if (rcompute__program_count == rcompute__program_cap)
+    {
+        int new_cap = rcompute__program_cap ? rcompute__program_cap * 2 : 16;
+        rcompute__program_info *p = (rcompute__program_info *)realloc(
+            rcompute__programs, new_cap * sizeof(rcompute__program_info));
+        if (!p)
+            return -1;
+        rcompute__programs = p;
+        rcompute__program_cap = new_cap;
     }
-    else
+
+    index = rcompute__program_count++;
+    rcompute__program_info *info = &rcompute__programs[index];
+    memset(info, 0, sizeof(*info));
+    info->program = program;
+    info->shared_bytes = -1;
+
+    // Introspect default-block uniforms; block members have no location
+    GLint num_uniforms = 0;
+    glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &num_uniforms);
+    for (GLint u = 0; u < num_uniforms; u++)
     {
-        // No version line, just prepend defines
-        char *insert_pos = modified_src;
-        for (int i = 0; i < count; i++)
+        const GLenum props[3] = {GL_LOCATION, GL_ARRAY_SIZE, GL_TYPE};
+        GLint values[3] = {-1, 0, 0};
+        glGetProgramResourceiv(program, GL_UNIFORM, (GLuint)u, 3, props, 3, NULL, values);
+        if (values[0] < 0)
+            continue;
+
+        char name[256];
+        glGetProgramResourceName(program, GL_UNIFORM, (GLuint)u, sizeof(name), NULL, name);
+        rcompute__uniform_insert(info, name, values[0]);
+
+        // Image uniforms: one entry per unit the array covers
+        if (values[2] >= GL_IMAGE_1D && values[2] <= GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY)
         {
-            if (defines[i])
+            for (GLint e = 0; e < values[1]; e++)
             {
-                int written = sprintf(insert_pos, "#define %s\n", defines[i]);
-                insert_pos += written;
+                GLint unit = 0;
+                glGetUniformiv(program, values[0] + e, &unit);
+                rcompute__resource_add(info, (GLuint)unit, 1, name);
+                info->resources[info->resource_count - 1].type = (GLenum)values[2];
             }
         }
-        strcpy(insert_pos, src);
-    }
 
-    GLuint prog = rcompute_compile(modified_src);
-    free(modified_src);
-    return prog;
-}
+        // "weights[0]" is also addressable as "weights"
+        size_t len = strlen(name);
+        if (len > 3 && strcmp(name + len - 3, "[0]") == 0)
+        {
+            name[len - 3] = '\0';
+            rcompute__uniform_insert(info, name, values[0]);
+        }
+    }
 
-// ---------------------------------
-// set active program
-// ---------------------------------
-void rcompute_set_program(rcompute *c, GLuint program)
-{
-    if (!c)
+    GLint num_blocks = 0;
+    glGetProgramInterfaceiv(program, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &num_blocks);
+    for (GLint b = 0; b < num_blocks; b++)
     {
-        rcompute__err("Invalid compute context");
-        return;
+        const GLenum props[2] = {GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+        GLint values[2] = {0, 0};
+        glGetProgramResourceiv(program, GL_SHADER_STORAGE_BLOCK, (GLuint)b, 2, props, 2, NULL, values);
+        char name[256];
+        glGetProgramResourceName(program, GL_SHADER_STORAGE_BLOCK, (GLuint)b, sizeof(name), NULL, name);
+        rcompute__resource_add(info, (GLuint)values[0], 0, name);
+        info->resources[info->resource_count - 1].min_size = values[1];
+        info->resources[info->resource_count - 1].block_index = b;
+    }
+
+    // Element layout of trailing unsized arrays, for the debug overshoot check
+    GLint num_vars = 0;
+    glGetProgramInterfaceiv(program, GL_BUFFER_VARIABLE, GL_ACTIVE_RESOURCES, &num_vars);
+    for (GLint v = 0; v < num_vars; v++)
+    {
+        const GLenum props[6] = {GL_BLOCK_INDEX, GL_TOP_LEVEL_ARRAY_SIZE, GL_TOP_LEVEL_ARRAY_STRIDE,
+                                 GL_OFFSET, GL_ARRAY_SIZE, GL_ARRAY_STRIDE};
+        GLint values[6] = {-1, 1, 0, 0, 1, 0};
+        glGetProgramResourceiv(program, GL_BUFFER_VARIABLE, (GLuint)v, 6, props, 6, NULL, values);
+        // struct arrays report through the top-level properties, "float data[]" through its own
+        if (values[4] == 0 && values[5] > 0)
+        {
+            values[1] = 0;
+            values[2] = values[5];
+        }
+        if (values[1] != 0 || values[2] <= 0)
+            continue;
+        for (int i = 0; i < info->resource_count; i++)
+        {
+            rcompute__resource_use *use = &info->resources[i];
+            if (use->block_index != values[0])
+                continue;
+            // struct arrays list every member; the first one starts the element
+            if (use->array_stride == 0 || values[3] < use->array_offset)
+                use->array_offset = values[3];
+            use->array_stride = values[2];
+        }
+    }
+
+    glGetProgramiv(program, GL_COMPUTE_WORK_GROUP_SIZE, info->local_size);
+    info->group_offset_location = glGetUniformLocation(program, "rcompute_group_offset");
+
+    // readonly/writeonly aren't queryable; take them from the source while it is still attached
+    GLuint shader = 0;
+    GLsizei num_shaders = 0;
+    glGetAttachedShaders(program, 1, &num_shaders, &shader);
+    if (num_shaders > 0)
+    {
+        GLint len = 0;
+        glGetShaderiv(shader, GL_SHADER_SOURCE_LENGTH, &len);
+        char *src = len > 0 ? (char *)malloc(len) : NULL;
+        if (src)
+        {
+            glGetShaderSource(shader, len, NULL, src);
+            rcompute__resource_scan(info, src);
+            free(src);
+        }
+    }
+
+    rcompute__program_last = index;
+    return index;
+}
+
+// programs loaded from a binary have no shader attached; the caller still has the source
+static void rcompute__program_set_source(GLuint program, const char *src)
+{
+    int index = rcompute__program_register(program);
+    if (index >= 0)
+        rcompute__resource_scan(&rcompute__programs[index], src);
+}
+
+static void rcompute__program_forget(GLuint program)
+{
+    int index = rcompute__program_find(program);
+    if (index < 0)
+        return;
+
+    rcompute__program_info *info = &rcompute__programs[index];
+    for (int i = 0; i < info->uniform_cap; i++)
+        free(info->uniforms[i].name);
+    free(info->uniforms);
+    free(info->resources);
+    free(info->reflection); // one allocation holding the arrays too
+
+    rcompute__programs[index] = rcompute__programs[--rcompute__program_count];
+    rcompute__program_last = -1;
+}
+
+// a freshly linked program may reuse the name of one deleted behind our back
+static void rcompute__program_linked(GLuint program)
+{
+    rcompute__program_forget(program);
+    rcompute__program_register(program);
+}
+
+static void rcompute__delete_program(GLuint program)
+{
+    if (program == 0)
+        return;
+    rcompute__program_forget(program);
+    glDeleteProgram(program);
+}
+
+// name -> location through the program's table; misses (e.g. "weights[3]") are
+// resolved once with glGetUniformLocation and remembered, including -1
+static GLint rcompute__uniform_lookup(GLuint program, const char *name)
+{
+    int index = rcompute__program_register(program);
+    if (index < 0)
+        return glGetUniformLocation(program, name);
+
+    rcompute__program_info *info = &rcompute__programs[index];
+    if (info->uniform_cap > 0)
+    {
+        unsigned long long h = rcompute__fnv1a_str(14695981039346656037ULL, name);
+        int mask = info->uniform_cap - 1;
+        for (int i = (int)(h & mask); info->uniforms[i].name; i = (i + 1) & mask)
+        {
+            if (info->uniforms[i].hash == h && strcmp(info->uniforms[i].name, name) == 0)
+                return info->uniforms[i].location;
+        }
+    }
+
+    GLint loc = glGetUniformLocation(program, name);
+    rcompute__uniform_insert(info, name, loc);
+    return loc;
+}
+
+// ---------------------------------
+// Object registry
+// ---------------------------------
+static int rcompute__object_home(GLuint name, int kind, int cap)
+{
+    unsigned int h = (name * 2u + (unsigned int)kind) * 2654435761u;
+    return (int)(h & (unsigned int)(cap - 1));
+}
+
+static rcompute__object *rcompute__object_find(GLuint name, int kind)
+{
+    if (name == 0 || rcompute__object_cap == 0)
+        return NULL;
+    int mask = rcompute__object_cap - 1;
+    for (int i = rcompute__object_home(name, kind, rcompute__object_cap); rcompute__objects[i].name; i = (i + 1) & mask)
+    {
+        if (rcompute__objects[i].name == name && rcompute__objects[i].kind == kind)
+            return &rcompute__objects[i];
+    }
+    return NULL;
+}
+
+static void rcompute__object_place(const rcompute__object *obj)
+{
+    int mask = rcompute__object_cap - 1;
+    int i = rcompute__object_home(obj->name, obj->kind, rcompute__object_cap);
+    while (rcompute__objects[i].name)
+        i = (i + 1) & mask;
+    rcompute__objects[i] = *obj;
+}
+
+static void rcompute__track(GLuint name, int kind, GLsizeiptr size, int usage, const char *label, const char *file, int line)
+{
+    if (name == 0)
+        return;
+
+    if ((rcompute__object_count + 1) * 10 > rcompute__object_cap * 7)
+    {
+        int new_cap = rcompute__object_cap ? rcompute__object_cap * 2 : 64;
+        rcompute__object *old = rcompute__objects;
+        int old_cap = rcompute__object_cap;
+        rcompute__objects = (rcompute__object *)calloc(new_cap, sizeof(rcompute__object));
+        if (!rcompute__objects)
+        {
+            rcompute__objects = old;
+            return;
+        }
+        rcompute__object_cap = new_cap;
+        for (int i = 0; i < old_cap; i++)
+            if (old[i].name)
+                rcompute__object_place(&old[i]);
+        free(old);
+    }
+
+    rcompute__object obj;
+    memset(&obj, 0, sizeof(obj));
+    obj.name = name;
+    obj.kind = kind;
+    obj.size = size;
+    obj.usage = usage;
+    obj.file = file;
+    obj.line = line;
+    if (label)
+        snprintf(obj.label, sizeof(obj.label), "%s", label);
+
+    // A recycled name means the old object was deleted behind our back
+    rcompute__object *stale = rcompute__object_find(name, kind);
+    if (stale)
+    {
+        if (stale->kind != RCOMPUTE__OBJ_SLICE)
+            rcompute__live_bytes -= stale->size;
+        *stale = obj;
+    }
+    else
+    {
+        rcompute__object_place(&obj);
+        rcompute__object_count++;
+    }
+
+    if (kind == RCOMPUTE__OBJ_SLICE)
+        return; // bytes are accounted to the pool block
+    rcompute__live_bytes += size;
+    if (rcompute__live_bytes > rcompute__peak_bytes)
+        rcompute__peak_bytes = rcompute__live_bytes;
+}
+
+static void rcompute__untrack(GLuint name, int kind)
+{
+    rcompute__object *obj = rcompute__object_find(name, kind);
+    if (!obj)
+        return;
+
+    if (obj->kind != RCOMPUTE__OBJ_SLICE)
+        rcompute__live_bytes -= obj->size;
+    rcompute__object_count--;
+
+    // Backward-shift deletion keeps linear probe chains intact
+    int mask = rcompute__object_cap - 1;
+    int hole = (int)(obj - rcompute__objects);
+    rcompute__objects[hole].name = 0;
+    for (int i = (hole + 1) & mask; rcompute__objects[i].name; i = (i + 1) & mask)
+    {
+        int home = rcompute__object_home(rcompute__objects[i].name, rcompute__objects[i].kind, rcompute__object_cap);
+        int dist_hole = (hole - home) & mask;
+        int dist_cur = (i - home) & mask;
+        if (dist_hole < dist_cur)
+        {
+            rcompute__objects[hole] = rcompute__objects[i];
+            rcompute__objects[i].name = 0;
+            hole = i;
+        }
+    }
+}
+
+// resolve a buffer or slice handle to the GL buffer, base offset and size (size 0 = unknown)
+static GLuint rcompute__resolve_buffer(GLuint buf, GLsizeiptr *base, GLsizeiptr *size)
+{
+    *base = 0;
+    *size = 0;
+    if (buf & RCOMPUTE_SLICE_BIT)
+    {
+        rcompute__object *obj = rcompute__object_find(buf, RCOMPUTE__OBJ_SLICE);
+        if (!obj)
+            return 0;
+        *base = obj->offset;
+        *size = obj->size;
+        return obj->parent;
+    }
+    rcompute__object *obj = rcompute__object_find(buf, RCOMPUTE__OBJ_BUFFER);
+    if (obj)
+        *size = obj->size;
+    return buf;
+}
+
+static int rcompute__texel_size(GLenum format)
+{
+    switch (format)
+    {
+    case GL_R32F: case GL_R32I: case GL_R32UI: return 4;
+    case GL_RG32F: case GL_RG32I: case GL_RG32UI: return 8;
+    case GL_RGBA32F: case GL_RGBA32I: case GL_RGBA32UI: return 16;
+    case GL_R16F: case GL_R16I: case GL_R16UI: case GL_R16: return 2;
+    case GL_RG16F: case GL_RGBA8: case GL_RGBA8I: case GL_RGBA8UI: return 4;
+    case GL_RGBA16F: case GL_RGBA16I: case GL_RGBA16UI: case GL_RGBA16: return 8;
+    case GL_R8: case GL_R8I: case GL_R8UI: return 1;
+    default: return 4;
+    }
+}
+
+// ---------------------------------
+// Query pool and profiler
+// ---------------------------------
+static GLuint rcompute__timer_query(void)
+{
+    if (rcompute__timer_free_count > 0)
+        return rcompute__timer_free[--rcompute__timer_free_count];
+    GLuint q = 0;
+    glGenQueries(1, &q);
+    return q;
+}
+
+static void rcompute__timer_release(GLuint q)
+{
+    if (rcompute__timer_free_count == rcompute__timer_free_cap)
+    {
+        int new_cap = rcompute__timer_free_cap ? rcompute__timer_free_cap * 2 : 64;
+        GLuint *p = (GLuint *)realloc(rcompute__timer_free, new_cap * sizeof(GLuint));
+        if (!p)
+        {
+            glDeleteQueries(1, &q);
+            return;
+        }
+        rcompute__timer_free = p;
+        rcompute__timer_free_cap = new_cap;
+    }
+    rcompute__timer_free[rcompute__timer_free_count++] = q;
+}
+
+// monotonic CPU clock for profiler events; wall-clock fallbacks only where neither API is declared
+static long long rcompute__now_ns(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (long long)(now.QuadPart / freq.QuadPart) * 1000000000LL +
+           (long long)(now.QuadPart % freq.QuadPart) * 1000000000LL / freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#elif defined(TIME_UTC)
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#else
+    return (long long)time(NULL) * 1000000000LL;
+#endif
+}
+
+// reads GPU times of finished events, oldest first; wait = 1 blocks until all are in
+static void rcompute__prof_resolve(int wait)
+{
+    while (rcompute__prof_resolved < rcompute__prof_count)
+    {
+        rcompute__prof_event *ev = &rcompute__prof_events[rcompute__prof_resolved];
+        if (ev->query[1] == 0)
+            break; // still open
+        if (!wait)
+        {
+            GLint available = 0;
+            glGetQueryObjectiv(ev->query[1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            glGetQueryObjectui64v(ev->query[i], GL_QUERY_RESULT, &ev->gpu[i]);
+            rcompute__timer_release(ev->query[i]);
+            ev->query[i] = 0;
+        }
+        rcompute__prof_resolved++;
+    }
+}
+
+// opens an event; -1 when the profiler is off
+static int rcompute__prof_begin(const char *cat, const char *name, long long bytes)
+{
+    if (!rcompute__prof_enabled)
+        return -1;
+    if (rcompute__prof_count >= RCOMPUTE_PROFILER_MAX_EVENTS)
+    {
+        if (rcompute__prof_dropped++ == 0)
+            rcompute__err("Profiler event limit reached (RCOMPUTE_PROFILER_MAX_EVENTS); dropping events until "
+                          "rcompute_profiler_reset");
+        return -1;
+    }
+    if (rcompute__prof_count == rcompute__prof_cap)
+    {
+        int new_cap = rcompute__prof_cap ? rcompute__prof_cap * 2 : 256;
+        if (new_cap > RCOMPUTE_PROFILER_MAX_EVENTS)
+            new_cap = RCOMPUTE_PROFILER_MAX_EVENTS;
+        rcompute__prof_event *p = (rcompute__prof_event *)realloc(rcompute__prof_events,
+                                                                  new_cap * sizeof(rcompute__prof_event));
+        if (!p)
+            return -1;
+        rcompute__prof_events = p;
+        rcompute__prof_cap = new_cap;
+    }
+
+    rcompute__prof_event *ev = &rcompute__prof_events[rcompute__prof_count];
+    memset(ev, 0, sizeof(*ev));
+    ev->cat = cat;
+    snprintf(ev->name, sizeof(ev->name), "%s", name);
+    ev->bytes = bytes;
+    ev->query[0] = rcompute__timer_query();
+    glQueryCounter(ev->query[0], GL_TIMESTAMP);
+    ev->cpu[0] = rcompute__now_ns();
+    return rcompute__prof_count++;
+}
+
+static void rcompute__prof_end(int event)
+{
+    if (event < 0)
+        return;
+    rcompute__prof_event *ev = &rcompute__prof_events[event];
+    ev->query[1] = rcompute__timer_query();
+    glQueryCounter(ev->query[1], GL_TIMESTAMP);
+    ev->cpu[1] = rcompute__now_ns();
+    rcompute__prof_resolve(0); // keeps the number of live queries small
+}
+
+static void rcompute__json_string(FILE *f, const char *str)
+{
+    fputc('"', f);
+    for (; *str; str++)
+    {
+        if (*str == '"' || *str == '\\')
+            fprintf(f, "\\%c", *str);
+        else if ((unsigned char)*str < 0x20)
+            fprintf(f, "\\u%04x", *str);
+        else
+            fputc(*str, f);
+    }
+    fputc('"', f);
+}
+
+// ---------------------------------
+// Barrier inference
+// ---------------------------------
+static int rcompute__bit_index(GLbitfield bit)
+{
+    for (int i = 0; i < 32; i++)
+        if (bit == (1u << i))
+            return i;
+    return 0;
+}
+
+static void rcompute__barrier_issue(GLbitfield bits)
+{
+    int ev = rcompute__prof_begin("barrier", "glMemoryBarrier", 0);
+    if (ev >= 0)
+        rcompute__prof_events[ev].barriers = bits;
+    glMemoryBarrier(bits);
+    rcompute__prof_end(ev);
+    for (int i = 0; i < 32; i++)
+        if (bits & (1u << i))
+            rcompute__barrier_serial[i] = rcompute__serial;
+}
+
+// does an access of kind `bit` to this object need a barrier first? name 0 = unknown object
+static int rcompute__hazard(GLuint name, int image, GLbitfield bit)
+{
+    unsigned long long issued = rcompute__barrier_serial[rcompute__bit_index(bit)];
+    if (rcompute__unknown_write > issued)
+        return 1;
+    if (name == 0)
+        return rcompute__last_write > issued;
+    rcompute__object *obj = rcompute__object_find(name, image ? RCOMPUTE__OBJ_TEXTURE : RCOMPUTE__OBJ_BUFFER);
+    return obj && obj->write_serial > issued;
+}
+
+// before GL reads or writes a buffer outside a shader (copy, clear, map, subdata)
+static void rcompute__buffer_hazard(GLuint gl_buf, GLbitfield bit)
+{
+    if (rcompute__hazard(gl_buf, 0, bit))
+    {
+        rcompute__barrier_issue(bit);
+        rcompute__debug_log("Inferred barrier 0x%x before buffer access", bit);
+    }
+}
+
+// bytes: size of a bound SSBO range, 0 = the whole object
+static void rcompute__note_binding(int image, GLuint binding, GLuint name, GLsizeiptr bytes)
+{
+    if (binding >= RCOMPUTE__MAX_BINDINGS)
+        return;
+    (image ? rcompute__image_bound : rcompute__ssbo_bound)[binding] = name;
+    if (!image)
+        rcompute__ssbo_bound_bytes[binding] = bytes;
+}
+
+// bytes visible through a binding, 0 = unknown object
+static long long rcompute__bound_bytes(int image, GLuint binding)
+{
+    if (binding >= RCOMPUTE__MAX_BINDINGS)
+        return 0;
+    GLuint name = (image ? rcompute__image_bound : rcompute__ssbo_bound)[binding];
+    if (!image && name && rcompute__ssbo_bound_bytes[binding] > 0)
+        return rcompute__ssbo_bound_bytes[binding];
+    rcompute__object *obj = name ? rcompute__object_find(name, image ? RCOMPUTE__OBJ_TEXTURE : RCOMPUTE__OBJ_BUFFER) : NULL;
+    return obj ? obj->size : 0;
+}
+
+// upper bound on the bytes a dispatch moves: every bound resource, by declared access
+static void rcompute__dispatch_bytes(const rcompute__program_info *info, long long *read, long long *written)
+{
+    *read = *written = 0;
+    for (int i = 0; i < info->resource_count; i++)
+    {
+        const rcompute__resource_use *use = &info->resources[i];
+        long long bytes = rcompute__bound_bytes(use->image, use->binding);
+        if (use->access & RCOMPUTE__ACCESS_READ)
+            *read += bytes;
+        if (use->access & RCOMPUTE__ACCESS_WRITE)
+            *written += bytes;
+    }
+}
+
+static void rcompute__stats_resolve(int wait)
+{
+    int done = 0;
+    while (done < rcompute__sample_count)
+    {
+        rcompute__dispatch_sample *sample = &rcompute__samples[done];
+        if (!wait)
+        {
+            GLint available = 0;
+            glGetQueryObjectiv(sample->query[1], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+        }
+        GLuint64 t[2] = {0, 0};
+        for (int q = 0; q < 2; q++)
+        {
+            glGetQueryObjectui64v(sample->query[q], GL_QUERY_RESULT, &t[q]);
+            rcompute__timer_release(sample->query[q]);
+        }
+        done++;
+
+        int index = rcompute__program_find(sample->program);
+        if (index < 0)
+            continue; // deleted since
+        rcompute__program_info *info = &rcompute__programs[index];
+        double ms = t[1] > t[0] ? (t[1] - t[0]) / 1000000.0 : 0.0;
+        info->stat_dispatches++;
+        info->stat_invocations += sample->invocations;
+        info->stat_bytes_read += sample->bytes_read;
+        info->stat_bytes_written += sample->bytes_written;
+        info->stat_gpu_ms += ms;
+        if (rcompute__debug && ms > 0.0)
+            rcompute__debug_log("Dispatch '%s' %ux%ux%u: %.3f ms, %.2f GB/s, %.1f M invocations/s",
+                                info->label[0] ? info->label : "(unlabeled)", sample->groups[0], sample->groups[1],
+                                sample->groups[2], ms,
+                                (sample->bytes_read + sample->bytes_written) / (ms * 1e6),
+                                sample->invocations / (ms * 1e3));
+    }
+
+    if (done > 0)
+    {
+        memmove(rcompute__samples, rcompute__samples + done,
+                (rcompute__sample_count - done) * sizeof(rcompute__dispatch_sample));
+        rcompute__sample_count -= done;
+    }
+}
+
+// Debug: warn when a dispatch launches far more invocations than its largest bound array holds,
+// e.g. passing an element count where a group count was expected
+static void rcompute__check_overshoot(const rcompute__program_info *info, GLuint nx, GLuint ny, GLuint nz)
+{
+    long long capacity = 0;
+    for (int i = 0; i < info->resource_count; i++)
+    {
+        const rcompute__resource_use *use = &info->resources[i];
+        if (use->image || use->array_stride <= 0 || use->binding >= RCOMPUTE__MAX_BINDINGS)
+            continue;
+        long long bytes = rcompute__bound_bytes(0, use->binding);
+        if (bytes == 0)
+            return; // unknown size: can't judge
+        long long elements = (bytes - use->array_offset) / use->array_stride;
+        if (elements > capacity)
+            capacity = elements;
+    }
+
+    long long invocations = (long long)nx * ny * nz * info->local_size[0] * info->local_size[1] * info->local_size[2];
+    if (capacity > 0 && invocations >= capacity * 4)
+        rcompute__debug_log("Warning: dispatch launches %lld invocations for at most %lld array elements "
+                            "(group counts passed as element counts? see rcompute_dispatch_items_*)",
+                            invocations, capacity);
+}
+
+static const GLuint *rcompute__group_limits(void)
+{
+    if (rcompute__group_limit[0] == 0)
+    {
+        for (GLuint i = 0; i < 3; i++)
+        {
+            GLint limit = 0;
+            glGetIntegeri_v(GL_MAX_COMPUTE_WORK_GROUP_COUNT, i, &limit);
+            rcompute__group_limit[i] = limit > 0 ? (GLuint)limit : 65535u;
+        }
+    }
+    return rcompute__group_limit;
+}
+
+static void rcompute__group_offset(rcompute__program_info *info, GLuint x, GLuint y, GLuint z)
+{
+    if (info->group_offset[0] == x && info->group_offset[1] == y && info->group_offset[2] == z)
+        return;
+    glProgramUniform3ui(info->program, info->group_offset_location, x, y, z);
+    info->group_offset[0] = x;
+    info->group_offset[1] = y;
+    info->group_offset[2] = z;
+}
+
+// glDispatchCompute, split into chunks when an axis exceeds GL_MAX_COMPUTE_WORK_GROUP_COUNT.
+// Each chunk passes its first group to the shader's "uniform uvec3 rcompute_group_offset".
+// indirect >= 0 dispatches from GL_DISPATCH_INDIRECT_BUFFER instead; those can't be split.
+// Returns 0 when the grid is too large and the shader has no offset uniform.
+static int rcompute__dispatch_grid(rcompute__program_info *info, GLuint nx, GLuint ny, GLuint nz, GLintptr indirect)
+{
+    if (indirect >= 0)
+    {
+        if (info && info->group_offset_location >= 0)
+            rcompute__group_offset(info, 0, 0, 0);
+        glDispatchComputeIndirect(indirect);
+        return 1;
+    }
+
+    const GLuint *limit = rcompute__group_limits();
+    int has_offset = info && info->group_offset_location >= 0;
+    if (nx <= limit[0] && ny <= limit[1] && nz <= limit[2])
+    {
+        if (has_offset)
+            rcompute__group_offset(info, 0, 0, 0);
+        glDispatchCompute(nx, ny, nz);
+        return 1;
+    }
+
+    if (!has_offset)
+    {
+        char msg[256];
+        snprintf(msg, sizeof(msg),
+                 "Dispatch %ux%ux%u exceeds the work group count limit %ux%ux%u; "
+                 "declare 'uniform uvec3 rcompute_group_offset' to have it split",
+                 nx, ny, nz, limit[0], limit[1], limit[2]);
+        rcompute__err(msg);
+        return 0;
+    }
+
+    int chunks = 0;
+    for (GLuint z = 0; z < nz; z += limit[2])
+        for (GLuint y = 0; y < ny; y += limit[1])
+            for (GLuint x = 0; x < nx; x += limit[0])
+            {
+                rcompute__group_offset(info, x, y, z);
+                glDispatchCompute(nx - x < limit[0] ? nx - x : limit[0], ny - y < limit[1] ? ny - y : limit[1],
+                                  nz - z < limit[2] ? nz - z : limit[2]);
+                chunks++;
+            }
+    rcompute__debug_log("Split %ux%ux%u dispatch into %d chunks", nx, ny, nz, chunks);
+    return 1;
+}
+
+// closes a throughput sample opened before the dispatch; begin is its first timestamp query
+static void rcompute__stats_sample(const rcompute__program_info *info, GLuint begin, int ok, GLuint nx, GLuint ny,
+                                   GLuint nz, long long bytes_read, long long bytes_written)
+{
+    if (!ok)
+    {
+        rcompute__timer_release(begin);
+        return;
+    }
+    if (rcompute__sample_count == rcompute__sample_cap)
+    {
+        int new_cap = rcompute__sample_cap ? rcompute__sample_cap * 2 : 64;
+        rcompute__dispatch_sample *p = (rcompute__dispatch_sample *)realloc(
+            rcompute__samples, new_cap * sizeof(rcompute__dispatch_sample));
+        if (!p)
+        {
+            rcompute__timer_release(begin);
+            return;
+        }
+        rcompute__samples = p;
+        rcompute__sample_cap = new_cap;
+    }
+
+    rcompute__dispatch_sample *sample = &rcompute__samples[rcompute__sample_count++];
+    sample->query[0] = begin;
+    sample->query[1] = rcompute__timer_query();
+    glQueryCounter(sample->query[1], GL_TIMESTAMP);
+    sample->program = info->program;
+    sample->groups[0] = nx;
+    sample->groups[1] = ny;
+    sample->groups[2] = nz;
+    sample->invocations = (long long)nx * ny * nz * info->local_size[0] * info->local_size[1] * info->local_size[2];
+    sample->bytes_read = bytes_read;
+    sample->bytes_written = bytes_written;
+    rcompute__stats_resolve(0);
+}
+
+// glDispatchCompute preceded by only the barriers its inputs need, then records what it wrote.
+// indirect: offset into the bound GL_DISPATCH_INDIRECT_BUFFER, -1 = use nx, ny, nz
+static void rcompute__dispatch(GLuint program, GLuint nx, GLuint ny, GLuint nz, GLintptr indirect)
+{
+    int index = rcompute__program_register(program);
+    rcompute__program_info *info = index >= 0 ? &rcompute__programs[index] : NULL;
+
+    GLbitfield needed = 0;
+    if (!info)
+    {
+        if (rcompute__hazard(0, 0, GL_SHADER_STORAGE_BARRIER_BIT))
+            needed |= GL_SHADER_STORAGE_BARRIER_BIT;
+        if (rcompute__hazard(0, 1, GL_SHADER_IMAGE_ACCESS_BARRIER_BIT))
+            needed |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+    }
+    else
+    {
+        for (int i = 0; i < info->resource_count; i++)
+        {
+            const rcompute__resource_use *use = &info->resources[i];
+            GLbitfield bit = use->image ? GL_SHADER_IMAGE_ACCESS_BARRIER_BIT : GL_SHADER_STORAGE_BARRIER_BIT;
+            GLuint name = use->binding < RCOMPUTE__MAX_BINDINGS
+                              ? (use->image ? rcompute__image_bound : rcompute__ssbo_bound)[use->binding]
+                              : 0;
+            if (!(needed & bit) && rcompute__hazard(name, use->image, bit))
+                needed |= bit;
+            if (rcompute__debug && !use->image && name)
+            {
+                rcompute__object *obj = rcompute__object_find(name, RCOMPUTE__OBJ_BUFFER);
+                // a runtime-sized array may legally be empty; the reported size includes one element
+                GLint needed_size = use->array_stride > 0 ? use->array_offset : use->min_size;
+                if (obj && obj->size < needed_size)
+                    rcompute__debug_log("Warning: buffer at binding %u is %lld bytes, block '%s' needs at least %d",
+                                        use->binding, (long long)obj->size, use->name, needed_size);
+            }
+        }
+    }
+    if (needed)
+    {
+        rcompute__barrier_issue(needed);
+        rcompute__debug_log("Inferred barrier 0x%x before dispatch", needed);
+    }
+    if (rcompute__debug && info && indirect < 0)
+        rcompute__check_overshoot(info, nx, ny, nz);
+
+    long long bytes_read = 0, bytes_written = 0;
+    int measure = info && (rcompute__stats_enabled || rcompute__debug);
+    if (info && (measure || rcompute__prof_enabled))
+        rcompute__dispatch_bytes(info, &bytes_read, &bytes_written);
+    GLuint sample_query = 0;
+    if (measure)
+    {
+        sample_query = rcompute__timer_query();
+        glQueryCounter(sample_query, GL_TIMESTAMP);
+    }
+
+    int ev = -1;
+    if (rcompute__prof_enabled)
+    {
+        char name[48];
+        if (info && info->label[0])
+            snprintf(name, sizeof(name), "%s", info->label);
+        else
+            snprintf(name, sizeof(name), "program %u", program);
+        ev = rcompute__prof_begin("dispatch", name, 0);
+        if (ev >= 0)
+        {
+            rcompute__prof_event *e = &rcompute__prof_events[ev];
+            e->groups[0] = nx;
+            e->groups[1] = ny;
+            e->groups[2] = nz;
+            e->indirect = indirect >= 0;
+            e->bytes = bytes_read;
+            e->bytes_written = bytes_written;
+        }
+    }
+    int ok = rcompute__dispatch_grid(info, nx, ny, nz, indirect);
+    rcompute__prof_end(ev);
+    if (measure)
+        rcompute__stats_sample(info, sample_query, ok, indirect >= 0 ? 0 : nx, ny, nz, bytes_read, bytes_written);
+    if (!ok)
+        return;
+    rcompute__serial++;
+
+    if (!info)
+    {
+        rcompute__last_write = rcompute__unknown_write = rcompute__serial;
+        return;
+    }
+
+    int client_mapped = 0;
+    for (int i = 0; i < info->resource_count; i++)
+    {
+        const rcompute__resource_use *use = &info->resources[i];
+        if (!(use->access & RCOMPUTE__ACCESS_WRITE))
+            continue;
+        GLuint name = use->binding < RCOMPUTE__MAX_BINDINGS
+                          ? (use->image ? rcompute__image_bound : rcompute__ssbo_bound)[use->binding]
+                          : 0;
+        rcompute__object *obj = name ? rcompute__object_find(name, use->image ? RCOMPUTE__OBJ_TEXTURE : RCOMPUTE__OBJ_BUFFER) : NULL;
+        rcompute__last_write = rcompute__serial;
+        if (!obj)
+        {
+            rcompute__unknown_write = rcompute__serial;
+            continue;
+        }
+        obj->write_serial = rcompute__serial;
+        client_mapped |= obj->persistent;
+    }
+
+    // The CPU reads persistent mappings directly, so there is no later call to hang this on
+    if (client_mapped)
+        rcompute__barrier_issue(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+}
+
+// ---------------------------------
+// Version check
+// ---------------------------------
+int rcompute_check_version(int required_major, int required_minor)
+{
+    const GLubyte *version = glGetString(GL_VERSION);
+    if (!version) return 0;
+    
+    int major = 0, minor = 0;
+    sscanf((const char *)version, "%d.%d", &major, &minor);
+    
+    if (major > required_major) return 1;
+    if (major == required_major && minor >= required_minor) return 1;
+    return 0;
+}
+
+// ---------------------------------
+// load GL entry points for the current context
+// ---------------------------------
+static int rcompute__load_gl(void)
+{
+    glewExperimental = GL_TRUE;
+    GLenum res = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLX-built GLEW reports this on EGL contexts but still loads everything
+    if (res == GLEW_ERROR_NO_GLX_DISPLAY)
+        res = GLEW_OK;
+#endif
+    if (res != GLEW_OK)
+    {
+        rcompute__err("Failed to initialize GLEW");
+        return 0;
+    }
+    glGetError(); // glewInit may leave GL_INVALID_ENUM on core contexts
+    return 1;
+}
+
+#ifndef RCOMPUTE_NO_GLFW
+// ---------------------------------
+// create invisible 1×1 GLFW window
+// ---------------------------------
+static int rcompute__init_glfw(rcompute *c, int gl_major, int gl_minor)
+{
+    if (!rcompute__glfw_initialized)
+    {
+        if (!glfwInit())
+        {
+            rcompute__err("Failed to initialize GLFW");
+            return 0;
+        }
+        rcompute__glfw_initialized = 1;
+    }
+
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, gl_major);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, gl_minor);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    c->window = glfwCreateWindow(1, 1, "", NULL, NULL);
+    if (!c->window)
+    {
+        rcompute__err("Failed to create GLFW window");
+        return 0;
+    }
+
+    glfwMakeContextCurrent(c->window);
+    if (!rcompute__load_gl())
+    {
+        glfwDestroyWindow(c->window);
+        c->window = NULL;
+        return 0;
+    }
+    return 1;
+}
+#endif
+
+#ifdef RCOMPUTE_USE_EGL
+// ---------------------------------
+// create surfaceless EGL context
+// ---------------------------------
+static int rcompute__egl_has_ext(const char *list, const char *name)
+{
+    if (!list || !name) return 0;
+    size_t len = strlen(name);
+    const char *p = list;
+    while ((p = strstr(p, name)) != NULL)
+    {
+        if ((p == list || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0'))
+            return 1;
+        p += len;
+    }
+    return 0;
+}
+
+static EGLDisplay rcompute__egl_open_display(void)
+{
+    const char *client_ext = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    EGLint major, minor;
+
+    // Mesa surfaceless platform: no window system or device node needed (llvmpipe works)
+    if (get_platform_display && rcompute__egl_has_ext(client_ext, "EGL_MESA_platform_surfaceless"))
+    {
+        EGLDisplay dpy = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        if (dpy != EGL_NO_DISPLAY && eglInitialize(dpy, &major, &minor))
+        {
+            rcompute__debug_log("EGL %d.%d via EGL_MESA_platform_surfaceless", major, minor);
+            return dpy;
+        }
+    }
+
+    // Device platform: pick the first enumerated device that initializes
+    if (get_platform_display && rcompute__egl_has_ext(client_ext, "EGL_EXT_device_enumeration") &&
+        rcompute__egl_has_ext(client_ext, "EGL_EXT_platform_device"))
+    {
+        PFNEGLQUERYDEVICESEXTPROC query_devices =
+            (PFNEGLQUERYDEVICESEXTPROC)eglGetProcAddress("eglQueryDevicesEXT");
+        EGLDeviceEXT devices[16];
+        EGLint num_devices = 0;
+        if (query_devices && query_devices(16, devices, &num_devices))
+        {
+            for (EGLint i = 0; i < num_devices; i++)
+            {
+                EGLDisplay dpy = get_platform_display(EGL_PLATFORM_DEVICE_EXT, devices[i], NULL);
+                if (dpy != EGL_NO_DISPLAY && eglInitialize(dpy, &major, &minor))
+                {
+                    rcompute__debug_log("EGL %d.%d via EGL_EXT_platform_device (device %d)", major, minor, i);
+                    return dpy;
+                }
+            }
+        }
+    }
+
+    // Last resort: whatever the default display is
+    EGLDisplay dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (dpy != EGL_NO_DISPLAY && eglInitialize(dpy, &major, &minor))
+    {
+        rcompute__debug_log("EGL %d.%d via default display", major, minor);
+        return dpy;
+    }
+    return EGL_NO_DISPLAY;
+}
+
+static int rcompute__init_egl(rcompute *c, int gl_major, int gl_minor)
+{
+    EGLDisplay dpy = rcompute__egl_open_display();
+    if (dpy == EGL_NO_DISPLAY)
+    {
+        rcompute__err("Failed to open EGL display");
+        return 0;
+    }
+
+    const char *dpy_ext = eglQueryString(dpy, EGL_EXTENSIONS);
+    if (!rcompute__egl_has_ext(dpy_ext, "EGL_KHR_surfaceless_context"))
+    {
+        rcompute__err("EGL display lacks EGL_KHR_surfaceless_context");
+        return 0;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        rcompute__err("EGL does not support desktop OpenGL");
+        return 0;
+    }
+
+    // Surfaceless contexts don't need a config; prefer none when allowed
+    EGLConfig config = (EGLConfig)0;
+    if (!rcompute__egl_has_ext(dpy_ext, "EGL_KHR_no_config_context"))
+    {
+        const EGLint config_attribs[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+        EGLint num_configs = 0;
+        if (!eglChooseConfig(dpy, config_attribs, &config, 1, &num_configs) || num_configs < 1)
+        {
+            rcompute__err("No EGL config supports desktop OpenGL");
+            return 0;
+        }
+    }
+
+    const EGLint context_attribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, gl_major,
+        EGL_CONTEXT_MINOR_VERSION, gl_minor,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE};
+    EGLContext ctx = eglCreateContext(dpy, config, EGL_NO_CONTEXT, context_attribs);
+    if (ctx == EGL_NO_CONTEXT)
+    {
+        rcompute__err("Failed to create EGL context");
+        return 0;
+    }
+
+    if (!eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx))
+    {
+        rcompute__err("Failed to make EGL context current");
+        eglDestroyContext(dpy, ctx);
+        return 0;
+    }
+
+    c->egl_display = (void *)dpy;
+    c->egl_context = (void *)ctx;
+
+    if (!rcompute__load_gl())
+    {
+        eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(dpy, ctx);
+        c->egl_display = NULL;
+        c->egl_context = NULL;
+        return 0;
+    }
+    return 1;
+}
+#endif
+
+// ---------------------------------
+// pick backend and create context
+// ---------------------------------
+int rcompute_init_ex(rcompute *c, int gl_major, int gl_minor, rcompute_backend backend)
+{
+    if (!c)
+        return 0;
+
+    // Initialize to safe state
+    c->window = NULL;
+    c->program = 0;
+    c->last_program = 0;
+    c->backend = RCOMPUTE_BACKEND_AUTO;
+    c->egl_display = NULL;
+    c->egl_context = NULL;
+    c->param_ubo = 0;
+    c->param_ubo_size = 0;
+    c->param_ubo_head = 0;
+    c->param_ubo_align = 0;
+
+    if (backend == RCOMPUTE_BACKEND_AUTO)
+    {
+        const char *env = getenv("RCOMPUTE_BACKEND");
+        if (env && strcmp(env, "egl") == 0)
+            backend = RCOMPUTE_BACKEND_EGL;
+        else if (env && strcmp(env, "glfw") == 0)
+            backend = RCOMPUTE_BACKEND_GLFW;
+    }
+
+    int ok = 0;
+#ifdef RCOMPUTE_USE_EGL
+    if (backend == RCOMPUTE_BACKEND_AUTO || backend == RCOMPUTE_BACKEND_EGL)
+    {
+        ok = rcompute__init_egl(c, gl_major, gl_minor);
+        if (ok)
+            c->backend = RCOMPUTE_BACKEND_EGL;
+    }
+#else
+    if (backend == RCOMPUTE_BACKEND_EGL)
+        rcompute__err("EGL backend not compiled in (define RCOMPUTE_USE_EGL)");
+#endif
+
+#ifndef RCOMPUTE_NO_GLFW
+    if (!ok && (backend == RCOMPUTE_BACKEND_AUTO || backend == RCOMPUTE_BACKEND_GLFW))
+    {
+        ok = rcompute__init_glfw(c, gl_major, gl_minor);
+        if (ok)
+            c->backend = RCOMPUTE_BACKEND_GLFW;
+    }
+#else
+    if (backend == RCOMPUTE_BACKEND_GLFW)
+        rcompute__err("GLFW backend not compiled in (RCOMPUTE_NO_GLFW is defined)");
+#endif
+
+    if (!ok)
+        return 0;
+
+    rcompute__debug_log("Initialized OpenGL %d.%d context (%s)", gl_major, gl_minor,
+                        c->backend == RCOMPUTE_BACKEND_EGL ? "EGL" : "GLFW");
+    return 1;
+}
+
+// ---------------------------------
+int rcompute_init(rcompute *c, int gl_major, int gl_minor)
+{
+    return rcompute_init_ex(c, gl_major, gl_minor, RCOMPUTE_BACKEND_AUTO);
+}
+
+// ---------------------------------
+// compile compute shader
+// ---------------------------------
+static GLuint rcompute__compile_link(const char *src, int retrievable)
+{
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(shader, 1, &src, 0);
+    glCompileShader(shader);
+
+    GLint ok;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok)
+    {
+        char log[4096];
+        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        rcompute__err(log);
+        glDeleteShader(shader);
+        return 0;
+    }
+
+    GLuint prog = glCreateProgram();
+    if (retrievable)
+        glProgramParameteri(prog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(prog, shader);
+    glLinkProgram(prog);
+    glDeleteShader(shader);
+
+    glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+    if (!ok)
+    {
+        char log[4096];
+        glGetProgramInfoLog(prog, sizeof(log), NULL, log);
+        rcompute__err(log);
+        glDeleteProgram(prog);
+        return 0;
+    }
+
+    rcompute__program_linked(prog);
+    return prog;
+}
+
+// ---------------------------------
+// Program binary cache
+// ---------------------------------
+#define RCOMPUTE__CACHE_MAGIC 0x42504352u // "RCPB"
+
+void rcompute_set_cache_dir(const char *dir)
+{
+    rcompute__cache_dir_set = 1;
+    snprintf(rcompute__cache_dir, sizeof(rcompute__cache_dir), "%s", dir ? dir : "");
+    rcompute__debug_log("Program cache %s%s", dir ? "at " : "disabled", dir ? dir : "");
+}
+
+void rcompute_get_cache_stats(int *hits, int *misses)
+{
+    if (hits) *hits = rcompute__cache_hits;
+    if (misses) *misses = rcompute__cache_misses;
+}
+
+// hashes a source into a cache key; returns 0 if caching is off
+static int rcompute__cache_key(const char *src, unsigned long long *key)
+{
+    if (!rcompute__cache_dir_set)
+    {
+        const char *env = getenv("RCOMPUTE_CACHE_DIR");
+        rcompute_set_cache_dir(env && env[0] ? env : NULL);
+    }
+    if (!rcompute__cache_dir[0])
+        return 0;
+
+    GLint num_formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+    if (num_formats <= 0)
+        return 0;
+
+    // Binaries are only valid for the exact driver that produced them
+    unsigned long long h = 14695981039346656037ULL;
+    h = rcompute__fnv1a_str(h, src);
+    h = rcompute__fnv1a_str(h, (const char *)glGetString(GL_VENDOR));
+    h = rcompute__fnv1a_str(h, (const char *)glGetString(GL_RENDERER));
+    h = rcompute__fnv1a_str(h, (const char *)glGetString(GL_VERSION));
+
+    *key = h ? h : 1;
+    return 1;
+}
+
+static void rcompute__cache_path(unsigned long long key, char *path, size_t path_size)
+{
+    snprintf(path, path_size, "%s/%016llx.bin", rcompute__cache_dir, key);
+}
+
+static GLuint rcompute__cache_load(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return 0;
+
+    unsigned int header[3]; // magic, format, length
+    if (fread(header, sizeof(header), 1, f) != 1 || header[0] != RCOMPUTE__CACHE_MAGIC || header[2] == 0)
+    {
+        fclose(f);
+        return 0;
+    }
+
+    void *blob = malloc(header[2]);
+    if (!blob || fread(blob, 1, header[2], f) != header[2])
+    {
+        free(blob);
+        fclose(f);
+        return 0;
+    }
+    fclose(f);
+
+    GLuint prog = glCreateProgram();
+    glProgramBinary(prog, (GLenum)header[1], blob, (GLsizei)header[2]);
+    free(blob);
+
+    // Driver updates etc. make old blobs invalid; treat as a miss
+    GLint ok = 0;
+    glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+    if (!ok)
+    {
+        glDeleteProgram(prog);
+        glGetError(); // a rejected format may raise GL_INVALID_ENUM
+        rcompute__debug_log("Program cache blob rejected: %s", path);
+        return 0;
+    }
+    rcompute__program_linked(prog);
+    return prog;
+}
+
+static unsigned long rcompute__process_id(void)
+{
+#ifdef _WIN32
+    return (unsigned long)GetCurrentProcessId();
+#else
+    return (unsigned long)getpid();
+#endif
+}
+
+// rename over an existing file; plain rename fails on Windows when the target exists
+static int rcompute__replace_file(const char *from, const char *to)
+{
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+static void rcompute__cache_store(const char *path, GLuint prog)
+{
+    GLint len = 0;
+    glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH, &len);
+    if (len <= 0)
+        return;
+
+    void *blob = malloc(len);
+    if (!blob)
+        return;
+
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(prog, len, &written, &format, blob);
+    if (written <= 0)
+    {
+        free(blob);
+        return;
+    }
+
+    // Write to a temp file private to this process and store, then rename, so concurrent
+    // processes never share a temp file or see partial blobs
+    static unsigned int serial = 0;
+    char tmp_path[640];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.%lu.%u.tmp", path, rcompute__process_id(), serial++);
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f)
+    {
+        free(blob);
+        rcompute__debug_log("Program cache not writable: %s", tmp_path);
+        return;
+    }
+
+    unsigned int header[3] = {RCOMPUTE__CACHE_MAGIC, (unsigned int)format, (unsigned int)written};
+    int ok = fwrite(header, sizeof(header), 1, f) == 1 &&
+             fwrite(blob, 1, written, f) == (size_t)written;
+    ok = (fclose(f) == 0) && ok;
+    free(blob);
+
+    if (!ok || !rcompute__replace_file(tmp_path, path))
+        remove(tmp_path);
+    else
+        rcompute__debug_log("Program cache stored: %s (%d bytes)", path, (int)written);
+}
+
+GLuint rcompute_compile(const char *src)
+{
+    if (!src)
+    {
+        rcompute__err("Shader source is NULL");
+        return 0;
+    }
+
+    unsigned long long key;
+    if (!rcompute__cache_key(src, &key))
+        return rcompute__compile_link(src, 0);
+
+    char path[600];
+    rcompute__cache_path(key, path, sizeof(path));
+    GLuint prog = rcompute__cache_load(path);
+    if (prog)
+    {
+        rcompute__program_set_source(prog, src);
+        rcompute__cache_hits++;
+        rcompute__debug_log("Program cache hit: %s", path);
+        return prog;
+    }
+
+    rcompute__cache_misses++;
+    prog = rcompute__compile_link(src, 1);
+    if (prog)
+        rcompute__cache_store(path, prog);
+    return prog;
+}
+
+// ---------------------------------
+// Async / parallel compilation
+// ---------------------------------
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+static int rcompute__has_gl_extension(const char *name)
+{
+    GLint n = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+    for (GLint i = 0; i < n; i++)
+    {
+        const char *ext = (const char *)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (ext && strcmp(ext, name) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+static int rcompute__pending_find(GLuint program)
+{
+    for (int i = 0; i < rcompute__pending_count; i++)
+        if (rcompute__pending[i].program == program)
+            return i;
+    return -1;
+}
+
+static int rcompute__pending_add(GLuint program, unsigned long long cache_key)
+{
+    if (rcompute__pending_count == rcompute__pending_cap)
+    {
+        int new_cap = rcompute__pending_cap ? rcompute__pending_cap * 2 : 16;
+        rcompute__pending_program *p = (rcompute__pending_program *)realloc(
+            rcompute__pending, new_cap * sizeof(rcompute__pending_program));
+        if (!p)
+            return 0;
+        rcompute__pending = p;
+        rcompute__pending_cap = new_cap;
+    }
+    rcompute__pending[rcompute__pending_count].program = program;
+    rcompute__pending[rcompute__pending_count].cache_key = cache_key;
+    rcompute__pending_count++;
+    return 1;
+}
+
+// collect link result of a pending program (blocks if not finished)
+static int rcompute__pending_finish(int index, GLuint *program)
+{
+    rcompute__pending_program entry = rcompute__pending[index];
+    rcompute__pending[index] = rcompute__pending[--rcompute__pending_count];
+
+    GLint ok = 0;
+    glGetProgramiv(entry.program, GL_LINK_STATUS, &ok);
+    if (!ok)
+    {
+        // A compile error surfaces as a link failure; prefer the shader log
+        char log[4096] = {0};
+        GLuint shader = 0;
+        GLsizei num_shaders = 0;
+        glGetAttachedShaders(entry.program, 1, &num_shaders, &shader);
+        GLint compiled = 1;
+        if (num_shaders > 0)
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+        if (!compiled)
+            glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        else
+            glGetProgramInfoLog(entry.program, sizeof(log), NULL, log);
+        rcompute__err(log);
+        rcompute__delete_program(entry.program);
+        *program = 0;
+        return RCOMPUTE_COMPILE_FAILED;
+    }
+
+    if (entry.cache_key)
+    {
+        char path[600];
+        rcompute__cache_path(entry.cache_key, path, sizeof(path));
+        rcompute__cache_store(path, entry.program);
+    }
+    rcompute__program_linked(entry.program);
+    return RCOMPUTE_COMPILE_READY;
+}
+
+int rcompute_compile_async(const char **sources, int count, GLuint *programs)
+{
+    if (!sources || !programs || count <= 0)
+    {
+        rcompute__err("Invalid parameters for async compile");
+        return 0;
+    }
+
+    if (rcompute__parallel_compile < 0)
+    {
+        rcompute__parallel_compile = rcompute__has_gl_extension("GL_KHR_parallel_shader_compile") ||
+                                     rcompute__has_gl_extension("GL_ARB_parallel_shader_compile");
+        rcompute__debug_log("Parallel shader compile %s", rcompute__parallel_compile ? "available" : "not available");
+    }
+
+    // Pass 1: resolve cache hits and kick off every compile before any link,
+    // so the driver can spread them across its compiler threads
+    GLuint *shaders = (GLuint *)calloc(count, sizeof(GLuint));
+    unsigned long long *keys = (unsigned long long *)calloc(count, sizeof(unsigned long long));
+    if (!shaders || !keys)
+    {
+        free(shaders);
+        free(keys);
+        rcompute__err("Failed to allocate memory for async compile");
+        return 0;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        programs[i] = 0;
+        if (!sources[i])
+        {
+            rcompute__err("Shader source is NULL");
+            continue;
+        }
+
+        if (rcompute__cache_key(sources[i], &keys[i]))
+        {
+            char path[600];
+            rcompute__cache_path(keys[i], path, sizeof(path));
+            programs[i] = rcompute__cache_load(path);
+            if (programs[i])
+            {
+                // same as the sync path: qualifiers and shared memory come from the source
+                rcompute__program_set_source(programs[i], sources[i]);
+                rcompute__cache_hits++;
+                rcompute__debug_log("Program cache hit: %s", path);
+                continue;
+            }
+            rcompute__cache_misses++;
+        }
+
+        shaders[i] = glCreateShader(GL_COMPUTE_SHADER);
+        glShaderSource(shaders[i], 1, &sources[i], 0);
+        glCompileShader(shaders[i]);
+    }
+
+    // Pass 2: link; status is only queried later by poll/wait
+    int submitted = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (programs[i])
+        {
+            submitted++;
+            continue;
+        }
+        if (!shaders[i])
+            continue;
+
+        GLuint prog = glCreateProgram();
+        if (keys[i])
+            glProgramParameteri(prog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glAttachShader(prog, shaders[i]);
+        glLinkProgram(prog);
+        glDeleteShader(shaders[i]); // freed once the program is deleted
+
+        if (!rcompute__pending_add(prog, keys[i]))
+        {
+            glDeleteProgram(prog);
+            rcompute__err("Failed to allocate memory for async compile");
+            continue;
+        }
+        programs[i] = prog;
+        submitted++;
+    }
+
+    free(shaders);
+    free(keys);
+    rcompute__debug_log("Async compile submitted: %d of %d programs", submitted, count);
+    return submitted;
+}
+
+int rcompute_compile_poll(GLuint *program)
+{
+    if (!program || *program == 0)
+        return RCOMPUTE_COMPILE_FAILED;
+
+    int index = rcompute__pending_find(*program);
+    if (index < 0)
+        return RCOMPUTE_COMPILE_READY; // cache hit or already collected
+
+    if (rcompute__parallel_compile > 0)
+    {
+        GLint done = 0;
+        glGetProgramiv(*program, GL_COMPLETION_STATUS_KHR, &done);
+        if (!done)
+            return RCOMPUTE_COMPILE_PENDING;
+    }
+    return rcompute__pending_finish(index, program);
+}
+
+int rcompute_compile_wait(GLuint *program)
+{
+    if (!program || *program == 0)
+        return 0;
+
+    int index = rcompute__pending_find(*program);
+    if (index < 0)
+        return 1;
+    return rcompute__pending_finish(index, program) == RCOMPUTE_COMPILE_READY;
+}
+
+int rcompute_compile_wait_all(GLuint *programs, int count)
+{
+    if (!programs)
+        return 0;
+
+    int ready = 0;
+    for (int i = 0; i < count; i++)
+        ready += rcompute_compile_wait(&programs[i]);
+    return ready;
+}
+
+// ---------------------------------
+// compile with preprocessor defines
+// ---------------------------------
+GLuint rcompute_compile_with_defines(const char *src, const char **defines, int count)
+{
+    if (!src)
+    {
+        rcompute__err("Shader source is NULL");
+        return 0;
+    }
+
+    // Calculate total length needed
+    size_t total_len = strlen(src) + 1;
+    for (int i = 0; i < count; i++)
+    {
+        if (defines[i])
+            total_len += strlen("#define ") + strlen(defines[i]) + 2; // +2 for newline
+    }
+
+    char *modified_src = (char *)malloc(total_len);
+    if (!modified_src)
+    {
+        rcompute__err("Failed to allocate memory for shader");
+        return 0;
+    }
+
+    // Find #version line and insert defines after it
+    const char *version_start = strstr(src, "#version");
+    const char *version_end = version_start ? strstr(version_start, "\n") : NULL;
+    
+    if (version_end)
+    {
+        size_t version_len = version_end - src + 1;
+        memcpy(modified_src, src, version_len);
+        char *insert_pos = modified_src + version_len;
+
+        // Add defines
+        for (int i = 0; i < count; i++)
+        {
+            if (defines[i])
+            {
+                int written = sprintf(insert_pos, "#define %s\n", defines[i]);
+                insert_pos += written;
+            }
+        }
+
+        // Add rest of source
+        strcpy(insert_pos, version_end + 1);
+    }
+    else
+    {
+        // No version line, just prepend defines
+        char *insert_pos = modified_src;
+        for (int i = 0; i < count; i++)
+        {
+            if (defines[i])
+            {
+                int written = sprintf(insert_pos, "#define %s\n", defines[i]);
+                insert_pos += written;
+            }
+        }
+        strcpy(insert_pos, src);
+    }
+
+    GLuint prog = rcompute_compile(modified_src);
+    free(modified_src);
+    return prog;
+}
+
+// ---------------------------------
+// Variant cache
+// ---------------------------------
+static int rcompute__cmp_str(const void *a, const void *b)
+{
+    return strcmp(*(const char *const *)a, *(const char *const *)b);
+}
+
+// trims, collapses whitespace, sorts and dedupes defines into one '\n'-joined string
+static char *rcompute__normalize_defines(const char **defines, int count)
+{
+    char **items = (char **)calloc(count > 0 ? count : 1, sizeof(char *));
+    if (!items)
+        return NULL;
+
+    size_t total = 1;
+    int n = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (!defines || !defines[i])
+            continue;
+        size_t len = strlen(defines[i]);
+        char *d = (char *)malloc(len + 1);
+        if (!d)
+            break;
+        size_t o = 0;
+        for (const char *p = defines[i]; *p; p++)
+        {
+            int ws = (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n');
+            if (!ws)
+                d[o++] = *p;
+            else if (o > 0 && d[o - 1] != ' ')
+                d[o++] = ' ';
+        }
+        if (o > 0 && d[o - 1] == ' ')
+            o--;
+        d[o] = '\0';
+        if (o == 0)
+        {
+            free(d);
+            continue;
+        }
+        items[n++] = d;
+        total += o + 1;
+    }
+
+    qsort(items, n, sizeof(char *), rcompute__cmp_str);
+
+    char *out = (char *)malloc(total);
+    if (out)
+    {
+        char *w = out;
+        for (int i = 0; i < n; i++)
+        {
+            if (i > 0 && strcmp(items[i], items[i - 1]) == 0)
+                continue;
+            size_t len = strlen(items[i]);
+            memcpy(w, items[i], len);
+            w += len;
+            *w++ = '\n';
+        }
+        *w = '\0';
+    }
+
+    for (int i = 0; i < n; i++)
+        free(items[i]);
+    free(items);
+    return out;
+}
+
+static int rcompute__variant_slot(unsigned long long key, unsigned long long src_hash, const char *defines)
+{
+    int mask = rcompute__variant_cap - 1;
+    for (int i = (int)(key & mask);; i = (i + 1) & mask)
+    {
+        rcompute__variant *v = &rcompute__variants[i];
+        if (v->key == 0)
+            return i;
+        if (v->key == key && v->src_hash == src_hash && strcmp(v->defines, defines) == 0)
+            return i;
+    }
+}
+
+static int rcompute__variant_rehash(int new_cap)
+{
+    rcompute__variant *old = rcompute__variants;
+    int old_cap = rcompute__variant_cap;
+
+    rcompute__variants = (rcompute__variant *)calloc(new_cap, sizeof(rcompute__variant));
+    if (!rcompute__variants)
+    {
+        rcompute__variants = old;
+        return 0;
+    }
+    rcompute__variant_cap = new_cap;
+
+    for (int i = 0; i < old_cap; i++)
+        if (old[i].key)
+            rcompute__variants[rcompute__variant_slot(old[i].key, old[i].src_hash, old[i].defines)] = old[i];
+    free(old);
+    return 1;
+}
+
+static rcompute__variant *rcompute__variant_by_program(GLuint program)
+{
+    if (program == 0)
+        return NULL;
+    for (int i = 0; i < rcompute__variant_cap; i++)
+        if (rcompute__variants[i].key && rcompute__variants[i].program == program)
+            return &rcompute__variants[i];
+    return NULL;
+}
+
+GLuint rcompute_compile_variant(const char *src, const char **defines, int count)
+{
+    if (!src)
+    {
+        rcompute__err("Shader source is NULL");
+        return 0;
+    }
+
+    char *norm = rcompute__normalize_defines(defines, count);
+    if (!norm)
+    {
+        rcompute__err("Failed to allocate memory for shader variant");
+        return 0;
+    }
+
+    unsigned long long src_hash = rcompute__fnv1a_str(14695981039346656037ULL, src);
+    unsigned long long key = rcompute__fnv1a_str(src_hash, norm);
+    if (key == 0)
+        key = 1;
+
+    if (rcompute__variant_cap == 0 || (rcompute__variant_count + 1) * 10 > rcompute__variant_cap * 7)
+    {
+        if (!rcompute__variant_rehash(rcompute__variant_cap ? rcompute__variant_cap * 2 : 64))
+        {
+            free(norm);
+            rcompute__err("Failed to allocate memory for shader variant");
+            return 0;
+        }
+    }
+
+    rcompute__variant *v = &rcompute__variants[rcompute__variant_slot(key, src_hash, norm)];
+    if (v->key)
+    {
+        free(norm);
+        v->refcount++;
+        rcompute__debug_log("Variant cache hit: program %u (refs=%d)", v->program, v->refcount);
+        return v->program;
+    }
+
+    GLuint prog = rcompute_compile_with_defines(src, defines, count);
+    if (!prog)
+    {
+        free(norm);
+        return 0;
+    }
+
+    v->key = key;
+    v->src_hash = src_hash;
+    v->defines = norm;
+    v->program = prog;
+    v->refcount = 1;
+    rcompute__variant_count++;
+    rcompute__debug_log("Variant cache miss: compiled program %u", prog);
+    return prog;
+}
+
+void rcompute_release_variant(GLuint program)
+{
+    rcompute__variant *v = rcompute__variant_by_program(program);
+    if (!v)
+    {
+        rcompute__err("Program is not a cached variant");
+        return;
+    }
+    if (v->refcount > 0)
+        v->refcount--;
+}
+
+int rcompute_evict_variants(int force)
+{
+    int evicted = 0;
+    for (int i = 0; i < rcompute__variant_cap; i++)
+    {
+        rcompute__variant *v = &rcompute__variants[i];
+        if (!v->key || (!force && v->refcount > 0))
+            continue;
+        rcompute__delete_program(v->program);
+        free(v->defines);
+        v->key = 0;
+        evicted++;
+    }
+    rcompute__variant_count -= evicted;
+
+    // Rehash survivors so probe chains stay intact
+    if (evicted > 0 && rcompute__variant_count > 0)
+        rcompute__variant_rehash(rcompute__variant_cap);
+    else if (rcompute__variant_count == 0)
+    {
+        free(rcompute__variants);
+        rcompute__variants = NULL;
+        rcompute__variant_cap = 0;
+    }
+
+    rcompute__debug_log("Evicted %d shader variants", evicted);
+    return evicted;
+}
+
+// ---------------------------------
+// set active program
+// ---------------------------------
+void rcompute_set_program(rcompute *c, GLuint program)
+{
+    if (!c)
+    {
+        rcompute__err("Invalid compute context");
+        return;
+    }
+    c->program = program;
+}
+
+// ---------------------------------
+void rcompute_program_destroy(GLuint program)
+{
+    if (rcompute__variant_by_program(program))
+    {
+        rcompute__err("Program is owned by the variant cache");
+        return;
+    }
+    rcompute__delete_program(program);
+}
+
+// ---------------------------------
+const rcompute_reflection *rcompute_reflect(GLuint program)
+{
+    int index = rcompute__program_register(program);
+    if (index < 0)
+    {
+        rcompute__err("Invalid program for reflection");
+        return NULL;
+    }
+    rcompute__program_info *info = &rcompute__programs[index];
+    if (info->reflection)
+        return info->reflection;
+
+    int blocks = 0, images = 0;
+    for (int i = 0; i < info->resource_count; i++)
+    {
+        if (info->resources[i].image)
+            images++;
+        else
+            blocks++;
+    }
+    GLint uniforms = 0;
+    glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniforms);
+
+    // one allocation: header, then the three arrays
+    size_t bytes = sizeof(rcompute_reflection) + blocks * sizeof(rcompute_reflect_block) +
+                   images * sizeof(rcompute_reflect_image) + uniforms * sizeof(rcompute_reflect_uniform);
+    rcompute_reflection *r = (rcompute_reflection *)calloc(1, bytes);
+    if (!r)
+    {
+        rcompute__err("Failed to allocate reflection");
+        return NULL;
+    }
+    rcompute_reflect_block *block = (rcompute_reflect_block *)(r + 1);
+    rcompute_reflect_image *image = (rcompute_reflect_image *)(block + blocks);
+    rcompute_reflect_uniform *uniform = (rcompute_reflect_uniform *)(image + images);
+    r->blocks = block;
+    r->images = image;
+    r->uniforms = uniform;
+
+    for (int i = 0; i < 3; i++)
+        r->local_size[i] = info->local_size[i];
+    r->shared_bytes = info->shared_bytes;
+
+    for (int i = 0; i < info->resource_count; i++)
+    {
+        const rcompute__resource_use *use = &info->resources[i];
+        int ro = use->access == RCOMPUTE__ACCESS_READ;
+        int wo = use->access == RCOMPUTE__ACCESS_WRITE;
+        if (use->image)
+        {
+            rcompute_reflect_image *img = &image[r->image_count++];
+            snprintf(img->name, sizeof(img->name), "%s", use->name);
+            img->unit = use->binding;
+            img->type = use->type;
+            img->format = use->format;
+            img->readonly = ro;
+            img->writeonly = wo;
+        }
+        else
+        {
+            rcompute_reflect_block *blk = &block[r->block_count++];
+            snprintf(blk->name, sizeof(blk->name), "%s", use->name);
+            blk->binding = use->binding;
+            blk->size = use->min_size;
+            blk->readonly = ro;
+            blk->writeonly = wo;
+        }
+    }
+
+    for (GLint u = 0; u < uniforms; u++)
+    {
+        const GLenum props[3] = {GL_LOCATION, GL_TYPE, GL_ARRAY_SIZE};
+        GLint values[3] = {-1, 0, 0};
+        glGetProgramResourceiv(program, GL_UNIFORM, (GLuint)u, 3, props, 3, NULL, values);
+        if (values[0] < 0)
+            continue; // member of a uniform block
+        rcompute_reflect_uniform *un = &uniform[r->uniform_count++];
+        glGetProgramResourceName(program, GL_UNIFORM, (GLuint)u, sizeof(un->name), NULL, un->name);
+        un->location = values[0];
+        un->type = (GLenum)values[1];
+        un->array_size = values[2];
+    }
+
+    info->reflection = r;
+    return r;
+}
+
+// ---------------------------------
+// Uniform helpers
+// ---------------------------------
+GLint rcompute_uniform_location(rcompute *c, const char *name)
+{
+    if (!c || !name || c->program == 0) return -1;
+    return rcompute__uniform_lookup(c->program, name);
+}
+
+// Setters use glProgramUniform* (GL 4.1+) so they never change the bound program
+void rcompute_set_uniform_int_at(rcompute *c, GLint loc, int value)
+{
+    if (!c || loc == -1) return;
+    glProgramUniform1i(c->program, loc, value);
+}
+
+void rcompute_set_uniform_uint_at(rcompute *c, GLint loc, unsigned int value)
+{
+    if (!c || loc == -1) return;
+    glProgramUniform1ui(c->program, loc, value);
+}
+
+void rcompute_set_uniform_float_at(rcompute *c, GLint loc, float value)
+{
+    if (!c || loc == -1) return;
+    glProgramUniform1f(c->program, loc, value);
+}
+
+void rcompute_set_uniform_vec2_at(rcompute *c, GLint loc, float x, float y)
+{
+    if (!c || loc == -1) return;
+    glProgramUniform2f(c->program, loc, x, y);
+}
+
+void rcompute_set_uniform_vec3_at(rcompute *c, GLint loc, float x, float y, float z)
+{
+    if (!c || loc == -1) return;
+    glProgramUniform3f(c->program, loc, x, y, z);
+}
+
+void rcompute_set_uniform_vec4_at(rcompute *c, GLint loc, float x, float y, float z, float w)
+{
+    if (!c || loc == -1) return;
+    glProgramUniform4f(c->program, loc, x, y, z, w);
+}
+
+void rcompute_set_uniform_mat4_at(rcompute *c, GLint loc, const float *matrix)
+{
+    if (!c || loc == -1 || !matrix) return;
+    glProgramUniformMatrix4fv(c->program, loc, 1, GL_FALSE, matrix);
+}
+
+void rcompute_set_uniform_float_array_at(rcompute *c, GLint loc, const float *values, int count)
+{
+    if (!c || loc == -1 || !values || count <= 0) return;
+    glProgramUniform1fv(c->program, loc, count, values);
+}
+
+// ---------------------------------
+// Parameter blocks
+// ---------------------------------
+#define RCOMPUTE__PARAM_RING_SIZE (256 * 1024)
+
+// debug only: compare the struct size with the block the program expects
+static void rcompute__check_param_block(GLuint program, GLuint binding, GLsizeiptr size)
+{
+    GLint num_blocks = 0;
+    glGetProgramInterfaceiv(program, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &num_blocks);
+    for (GLint b = 0; b < num_blocks; b++)
+    {
+        const GLenum props[2] = {GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE};
+        GLint values[2] = {0, 0};
+        glGetProgramResourceiv(program, GL_UNIFORM_BLOCK, (GLuint)b, 2, props, 2, NULL, values);
+        if ((GLuint)values[0] != binding)
+            continue;
+        if (values[1] != size)
+            rcompute__debug_log("Param block at binding %u is %d bytes but %lld were supplied (check std140 padding)",
+                                binding, values[1], (long long)size);
+        return;
+    }
+    rcompute__debug_log("Program %u has no uniform block at binding %u", program, binding);
+}
+
+void rcompute_set_params(rcompute *c, GLuint binding, const void *data, GLsizeiptr size)
+{
+    if (!c || !data || size <= 0)
+    {
+        rcompute__err("Invalid parameter block");
+        return;
+    }
+    if (size > RCOMPUTE__PARAM_RING_SIZE)
+    {
+        rcompute__err("Parameter block exceeds ring size");
+        return;
+    }
+
+    if (c->param_ubo == 0)
+    {
+        glGenBuffers(1, &c->param_ubo);
+        glBindBuffer(GL_UNIFORM_BUFFER, c->param_ubo);
+        glBufferData(GL_UNIFORM_BUFFER, RCOMPUTE__PARAM_RING_SIZE, NULL, GL_STREAM_DRAW);
+        rcompute__track(c->param_ubo, RCOMPUTE__OBJ_BUFFER, RCOMPUTE__PARAM_RING_SIZE, RCOMPUTE__USAGE_INTERNAL,
+                        "rcompute params", NULL, 0);
+        c->param_ubo_size = RCOMPUTE__PARAM_RING_SIZE;
+        c->param_ubo_head = 0;
+
+        // queried once here; a state query per upload would sit on the hot path
+        c->param_ubo_align = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &c->param_ubo_align);
+        if (c->param_ubo_align <= 0)
+            c->param_ubo_align = 256;
+    }
+    else
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, c->param_ubo);
+    }
+
+    GLint align = c->param_ubo_align;
+    GLsizeiptr offset = (c->param_ubo_head + align - 1) / align * align;
+
+    // On wrap, orphan the storage: in-flight dispatches keep the old copy and
+    // every range written afterwards is fresh, so the driver never has to stall
+    if (offset + size > c->param_ubo_size)
+    {
+        glBufferData(GL_UNIFORM_BUFFER, c->param_ubo_size, NULL, GL_STREAM_DRAW);
+        offset = 0;
+    }
+
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, c->param_ubo, offset, size);
+    c->param_ubo_head = offset + size;
+
+    if (rcompute__debug && c->program)
+        rcompute__check_param_block(c->program, binding, size);
+}
+
+void rcompute_set_uniform_int(rcompute *c, const char *name, int value)
+{
+    if (!c || !name) return;
+    rcompute_set_uniform_int_at(c, rcompute_uniform_location(c, name), value);
+}
+
+void rcompute_set_uniform_uint(rcompute *c, const char *name, unsigned int value)
+{
+    if (!c || !name) return;
+    rcompute_set_uniform_uint_at(c, rcompute_uniform_location(c, name), value);
+}
+
+void rcompute_set_uniform_float(rcompute *c, const char *name, float value)
+{
+    if (!c || !name) return;
+    rcompute_set_uniform_float_at(c, rcompute_uniform_location(c, name), value);
+}
+
+void rcompute_set_uniform_vec2(rcompute *c, const char *name, float x, float y)
+{
+    if (!c || !name) return;
+    rcompute_set_uniform_vec2_at(c, rcompute_uniform_location(c, name), x, y);
+}
+
+void rcompute_set_uniform_vec3(rcompute *c, const char *name, float x, float y, float z)
+{
+    if (!c || !name) return;
+    rcompute_set_uniform_vec3_at(c, rcompute_uniform_location(c, name), x, y, z);
+}
+
+void rcompute_set_uniform_vec4(rcompute *c, const char *name, float x, float y, float z, float w)
+{
+    if (!c || !name) return;
+    rcompute_set_uniform_vec4_at(c, rcompute_uniform_location(c, name), x, y, z, w);
+}
+
+void rcompute_set_uniform_mat4(rcompute *c, const char *name, const float *matrix)
+{
+    if (!c || !name || !matrix) return;
+    rcompute_set_uniform_mat4_at(c, rcompute_uniform_location(c, name), matrix);
+}
+
+void rcompute_set_uniform_float_array(rcompute *c, const char *name, const float *values, int count)
+{
+    if (!c || !name || !values) return;
+    rcompute_set_uniform_float_array_at(c, rcompute_uniform_location(c, name), values, count);
+}
+
+// ---------------------------------
+// compile compute shader from file
+// ---------------------------------
+GLuint rcompute_compile_file(const char *filepath)
+{
+    if (!filepath)
+    {
+        rcompute__err("Filepath is NULL");
+        return 0;
+    }
+
+    FILE *f = fopen(filepath, "rb");
+    if (!f)
+    {
+        rcompute__err_ex("Failed to open shader file: %s", filepath);
+        return 0;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    char *src = (char *)malloc(len + 1);
+    if (!src)
+    {
+        fclose(f);
+        rcompute__err("Failed to allocate memory for shader");
+        return 0;
+    }
+
+    size_t bytes_read = fread(src, 1, len, f);
+    if (bytes_read != (size_t)len)
+    {
+        free(src);
+        fclose(f);
+        rcompute__err("Failed to read complete shader file");
+        return 0;
+    }
+    src[len] = '\0';
+    fclose(f);
+
+    GLuint prog = rcompute_compile(src);
+    free(src);
+
+    if (prog)
+        rcompute_program_label(prog, filepath);
+    return prog;
+}
+
+// ---------------------------------
+// Hot-reload shader from file
+// ---------------------------------
+int rcompute_reload_shader(rcompute *c, const char *filepath)
+{
+    if (!c || !filepath)
+    {
+        rcompute__err("Invalid parameters for reload");
+        return 0;
+    }
+
+    GLuint old_program = c->program;
+    GLuint new_program = rcompute_compile_file(filepath);
+    
+    if (!new_program)
+    {
+        rcompute__err("Failed to reload shader");
+        return 0;
+    }
+
+    // Delete old program and use new one (cached variants are owned by the cache)
+    if (old_program != 0 && !rcompute__variant_by_program(old_program))
+        rcompute__delete_program(old_program);
+    
+    c->program = new_program;
+    c->last_program = 0; // old program is gone; force a rebind on next run
+    
+    rcompute__debug_log("Shader reloaded: %s", filepath);
+    return 1;
+}
+
+// ---------------------------------
+GLuint rcompute_buffer_tracked(GLsizeiptr size, const void *data, rcompute_usage usage, const char *file, int line)
+{
+    if (size <= 0)
+    {
+        rcompute__err("Buffer size must be positive");
+        return 0;
+    }
+
+    GLenum gl_usage;
+    switch (usage)
+    {
+    case RCOMPUTE_STATIC:
+        gl_usage = GL_STATIC_DRAW;
+        break;
+    case RCOMPUTE_STREAM:
+        gl_usage = GL_STREAM_COPY;
+        break;
+    case RCOMPUTE_DYNAMIC:
+    default:
+        gl_usage = GL_DYNAMIC_COPY;
+        break;
+    }
+
+    GLuint buf;
+    int ev = data ? rcompute__prof_begin("upload", "buffer create", size) : -1;
+    glGenBuffers(1, &buf);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, gl_usage);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    rcompute__prof_end(ev);
+
+    rcompute__track(buf, RCOMPUTE__OBJ_BUFFER, size, usage, NULL, file, line);
+    return buf;
+}
+
+// ---------------------------------
+GLuint rcompute_buffer_ex(GLsizeiptr size, const void *data, rcompute_usage usage)
+{
+    return rcompute_buffer_tracked(size, data, usage, NULL, 0);
+}
+
+// ---------------------------------
+GLuint rcompute_buffer(GLsizeiptr size, const void *data)
+{
+    return rcompute_buffer_ex(size, data, RCOMPUTE_DYNAMIC);
+}
+
+// ---------------------------------
+GLuint rcompute_buffer_zero(GLsizeiptr size)
+{
+    return rcompute_buffer_zero_tracked(size, NULL, 0);
+}
+
+// ---------------------------------
+GLuint rcompute_buffer_zero_tracked(GLsizeiptr size, const char *file, int line)
+{
+    // glBufferData(NULL) leaves contents undefined; clear explicitly
+    GLuint buf = rcompute_buffer_tracked(size, NULL, RCOMPUTE_DYNAMIC, file, line);
+    if (buf)
+        rcompute_buffer_clear(buf, 0, size);
+    return buf;
+}
+
+// ---------------------------------
+// Resolve a buffer range for clear/fill/copy; size 0 extends to the end
+static GLuint rcompute__buffer_range(GLuint buf, GLsizeiptr offset, GLsizeiptr *size, GLsizeiptr *gl_offset)
+{
+    GLsizeiptr buf_size = rcompute_buffer_size(buf);
+    if (*size == 0)
+        *size = buf_size - offset;
+    if (offset < 0 || *size <= 0 || offset + *size > buf_size)
+    {
+        rcompute__err("Buffer range exceeds buffer bounds");
+        return 0;
+    }
+
+    GLsizeiptr base, known_size;
+    GLuint gl_buf = rcompute__resolve_buffer(buf, &base, &known_size);
+    *gl_offset = base + offset;
+    return gl_buf;
+}
+
+// ---------------------------------
+void rcompute_buffer_clear(GLuint buf, GLsizeiptr offset, GLsizeiptr size)
+{
+    unsigned char zero = 0;
+    rcompute_buffer_fill(buf, offset, size, &zero, 1);
+}
+
+// ---------------------------------
+void rcompute_buffer_fill(GLuint buf, GLsizeiptr offset, GLsizeiptr size, const void *pattern, int pattern_size)
+{
+    GLenum internal_format, format, type;
+    switch (pattern_size)
+    {
+    case 1:
+        internal_format = GL_R8UI, format = GL_RED_INTEGER, type = GL_UNSIGNED_BYTE;
+        break;
+    case 2:
+        internal_format = GL_R16UI, format = GL_RED_INTEGER, type = GL_UNSIGNED_SHORT;
+        break;
+    case 4:
+        internal_format = GL_R32UI, format = GL_RED_INTEGER, type = GL_UNSIGNED_INT;
+        break;
+    case 8:
+        internal_format = GL_RG32UI, format = GL_RG_INTEGER, type = GL_UNSIGNED_INT;
+        break;
+    case 12:
+        internal_format = GL_RGB32UI, format = GL_RGB_INTEGER, type = GL_UNSIGNED_INT;
+        break;
+    case 16:
+        internal_format = GL_RGBA32UI, format = GL_RGBA_INTEGER, type = GL_UNSIGNED_INT;
+        break;
+    default:
+        rcompute__err("Fill pattern must be 1, 2, 4, 8, 12 or 16 bytes");
+        return;
+    }
+    if (buf == 0 || !pattern)
+    {
+        rcompute__err("Invalid buffer fill parameters");
+        return;
+    }
+
+    GLsizeiptr gl_offset;
+    GLuint gl_buf = rcompute__buffer_range(buf, offset, &size, &gl_offset);
+    if (!gl_buf)
+        return;
+    if (offset % pattern_size || size % pattern_size)
+    {
+        rcompute__err("Fill offset and size must be multiples of the pattern size");
+        return;
+    }
+
+    // Order after earlier shader writes to the same buffer
+    rcompute__buffer_hazard(gl_buf, GL_BUFFER_UPDATE_BARRIER_BIT);
+    int ev = rcompute__prof_begin("copy", "buffer fill", size);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, gl_buf);
+    if (gl_offset % pattern_size == 0)
+        glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, internal_format, gl_offset, size, format, type, pattern);
+    else
+    {
+        // A slice whose base isn't a multiple of the pattern (12-byte patterns on pool or arena
+        // slices) can't use glClearBufferSubData; upload the repeated pattern in chunks instead
+        GLsizeiptr chunk = size < 65536 - 65536 % pattern_size ? size : 65536 - 65536 % pattern_size;
+        unsigned char *host = (unsigned char *)malloc(chunk);
+        if (!host)
+        {
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            rcompute__prof_end(ev);
+            rcompute__err("Failed to allocate memory for buffer fill");
+            return;
+        }
+        for (GLsizeiptr i = 0; i < chunk; i += pattern_size)
+            memcpy(host + i, pattern, pattern_size);
+        for (GLsizeiptr done = 0; done < size; done += chunk)
+        {
+            GLsizeiptr n = size - done < chunk ? size - done : chunk;
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, gl_offset + done, n, host);
+        }
+        free(host);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    rcompute__prof_end(ev);
+}
+
+// ---------------------------------
+void rcompute_buffer_copy(GLuint src, GLsizeiptr src_offset, GLuint dst, GLsizeiptr dst_offset, GLsizeiptr size)
+{
+    if (src == 0 || dst == 0 || size <= 0)
+    {
+        rcompute__err("Invalid buffer copy parameters");
+        return;
+    }
+
+    GLsizeiptr gl_src_offset, gl_dst_offset, dst_size = size;
+    GLuint gl_src = rcompute__buffer_range(src, src_offset, &size, &gl_src_offset);
+    GLuint gl_dst = rcompute__buffer_range(dst, dst_offset, &dst_size, &gl_dst_offset);
+    if (!gl_src || !gl_dst)
+        return;
+    if (gl_src == gl_dst && gl_src_offset < gl_dst_offset + size && gl_dst_offset < gl_src_offset + size)
+    {
+        rcompute__err("Buffer copy ranges overlap");
+        return;
+    }
+
+    rcompute__buffer_hazard(gl_src, GL_BUFFER_UPDATE_BARRIER_BIT);
+    rcompute__buffer_hazard(gl_dst, GL_BUFFER_UPDATE_BARRIER_BIT);
+    int ev = rcompute__prof_begin("copy", "buffer copy", size);
+    glBindBuffer(GL_COPY_READ_BUFFER, gl_src);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, gl_dst);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, gl_src_offset, gl_dst_offset, size);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    rcompute__prof_end(ev);
+}
+
+// ---------------------------------
+void rcompute_buffer_write(GLuint buf, GLsizeiptr offset, GLsizeiptr size, const void *data)
+{
+    if (buf == 0 || !data || size <= 0)
+    {
+        rcompute__err("Invalid buffer write parameters");
+        return;
+    }
+
+    // Bounds checking
+    GLsizeiptr buf_size = rcompute_buffer_size(buf);
+    if (offset + size > buf_size)
+    {
+        rcompute__err("Buffer write exceeds buffer bounds");
+        return;
+    }
+
+    GLsizeiptr base, known_size;
+    GLuint gl_buf = rcompute__resolve_buffer(buf, &base, &known_size);
+    rcompute__buffer_hazard(gl_buf, GL_BUFFER_UPDATE_BARRIER_BIT);
+    int ev = rcompute__prof_begin("upload", "buffer write", size);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, gl_buf);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, base + offset, size, data);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    rcompute__prof_end(ev);
+    
+    rcompute__debug_log("Buffer write: %lld bytes at offset %lld", (long long)size, (long long)offset);
+}
+
+// ---------------------------------
+// Sub-allocating SSBO pool
+// ---------------------------------
+typedef struct
+{
+    GLsizeiptr offset;
+    GLsizeiptr size;
+} rcompute__range;
+
+typedef struct
+{
+    GLuint buffer;
+    GLsizeiptr size;
+    rcompute__range *free_ranges; // sorted by offset, coalesced
+    int free_count;
+    int free_cap;
+} rcompute__pool_block;
+
+struct rcompute_pool
+{
+    GLsizeiptr block_size;
+    GLsizeiptr align;
+    rcompute__pool_block *blocks;
+    int block_count;
+    int allocations;
+    GLsizeiptr used;
+};
+
+static int rcompute__has_buffer_storage(void)
+{
+    if (rcompute__buffer_storage < 0)
+        rcompute__buffer_storage = rcompute_check_version(4, 4) || rcompute__has_gl_extension("GL_ARB_buffer_storage");
+    return rcompute__buffer_storage;
+}
+
+static int rcompute__range_insert(rcompute__pool_block *block, int at, GLsizeiptr offset, GLsizeiptr size)
+{
+    if (block->free_count == block->free_cap)
+    {
+        int new_cap = block->free_cap ? block->free_cap * 2 : 8;
+        rcompute__range *r = (rcompute__range *)realloc(block->free_ranges, new_cap * sizeof(rcompute__range));
+        if (!r)
+            return 0;
+        block->free_ranges = r;
+        block->free_cap = new_cap;
+    }
+    memmove(&block->free_ranges[at + 1], &block->free_ranges[at], (block->free_count - at) * sizeof(rcompute__range));
+    block->free_ranges[at].offset = offset;
+    block->free_ranges[at].size = size;
+    block->free_count++;
+    return 1;
+}
+
+static int rcompute__pool_add_block(rcompute_pool *pool, GLsizeiptr size)
+{
+    rcompute__pool_block *blocks = (rcompute__pool_block *)realloc(
+        pool->blocks, (pool->block_count + 1) * sizeof(rcompute__pool_block));
+    if (!blocks)
+        return -1;
+    pool->blocks = blocks;
+
+    rcompute__pool_block *block = &pool->blocks[pool->block_count];
+    memset(block, 0, sizeof(*block));
+    glGenBuffers(1, &block->buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, block->buffer);
+    if (rcompute__has_buffer_storage())
+        glBufferStorage(GL_SHADER_STORAGE_BUFFER, size, NULL,
+                        GL_DYNAMIC_STORAGE_BIT | GL_MAP_READ_BIT | GL_MAP_WRITE_BIT);
+    else
+        glBufferData(GL_SHADER_STORAGE_BUFFER, size, NULL, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    block->size = size;
+    if (!rcompute__range_insert(block, 0, 0, size))
+    {
+        glDeleteBuffers(1, &block->buffer);
+        return -1;
+    }
+    rcompute__track(block->buffer, RCOMPUTE__OBJ_BUFFER, size, RCOMPUTE__USAGE_INTERNAL, "rcompute pool", NULL, 0);
+    rcompute__debug_log("Pool block %d created: %lld bytes", pool->block_count, (long long)size);
+    return pool->block_count++;
+}
+
+rcompute_pool *rcompute_pool_create(GLsizeiptr block_size)
+{
+    if (block_size <= 0)
+    {
+        rcompute__err("Pool block size must be positive");
+        return NULL;
+    }
+
+    rcompute_pool *pool = (rcompute_pool *)calloc(1, sizeof(rcompute_pool));
+    if (!pool)
+    {
+        rcompute__err("Failed to allocate pool");
+        return NULL;
+    }
+
+    GLint align = 256;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &align);
+    pool->align = align > 0 ? align : 256;
+    pool->block_size = (block_size + pool->align - 1) / pool->align * pool->align;
+    return pool;
+}
+
+GLuint rcompute_pool_alloc(rcompute_pool *pool, GLsizeiptr size, const void *data)
+{
+    if (!pool || size <= 0)
+    {
+        rcompute__err("Invalid pool allocation");
+        return 0;
+    }
+
+    // Every slice starts on an SSBO offset alignment boundary
+    GLsizeiptr aligned = (size + pool->align - 1) / pool->align * pool->align;
+
+    // First fit across existing blocks
+    int b = -1, r = -1;
+    for (int i = 0; i < pool->block_count && b < 0; i++)
+    {
+        for (int j = 0; j < pool->blocks[i].free_count; j++)
+        {
+            if (pool->blocks[i].free_ranges[j].size >= aligned)
+            {
+                b = i;
+                r = j;
+                break;
+            }
+        }
+    }
+    if (b < 0)
+    {
+        b = rcompute__pool_add_block(pool, aligned > pool->block_size ? aligned : pool->block_size);
+        if (b < 0)
+        {
+            rcompute__err("Failed to grow pool");
+            return 0;
+        }
+        r = 0;
+    }
+
+    rcompute__pool_block *block = &pool->blocks[b];
+    GLsizeiptr offset = block->free_ranges[r].offset;
+    block->free_ranges[r].offset += aligned;
+    block->free_ranges[r].size -= aligned;
+    if (block->free_ranges[r].size == 0)
+    {
+        memmove(&block->free_ranges[r], &block->free_ranges[r + 1], (block->free_count - r - 1) * sizeof(rcompute__range));
+        block->free_count--;
+    }
+
+    GLuint handle = RCOMPUTE_SLICE_BIT | rcompute__next_slice++;
+    if (rcompute__next_slice >= RCOMPUTE_SLICE_BIT)
+        rcompute__next_slice = 1;
+    rcompute__track(handle, RCOMPUTE__OBJ_SLICE, size, RCOMPUTE_DYNAMIC, NULL, NULL, 0);
+    rcompute__object *obj = rcompute__object_find(handle, RCOMPUTE__OBJ_SLICE);
+    if (!obj)
+    {
+        rcompute__err("Failed to register pool slice");
+        return 0;
+    }
+    obj->parent = block->buffer;
+    obj->offset = offset;
+    obj->pool = pool;
+
+    pool->allocations++;
+    pool->used += aligned;
+
+    if (data)
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, block->buffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+    return handle;
+}
+
+void rcompute_pool_free(rcompute_pool *pool, GLuint slice)
+{
+    rcompute__object *obj = rcompute__object_find(slice, RCOMPUTE__OBJ_SLICE);
+    if (!pool || !obj || obj->pool != pool)
+    {
+        rcompute__err("Slice does not belong to this pool");
+        return;
+    }
+
+    GLsizeiptr offset = obj->offset;
+    GLsizeiptr aligned = (obj->size + pool->align - 1) / pool->align * pool->align;
+    GLuint parent = obj->parent;
+    rcompute__untrack(slice, RCOMPUTE__OBJ_SLICE);
+
+    for (int b = 0; b < pool->block_count; b++)
+    {
+        rcompute__pool_block *block = &pool->blocks[b];
+        if (block->buffer != parent)
+            continue;
+
+        // Insert sorted, then coalesce with the neighbours
+        int at = 0;
+        while (at < block->free_count && block->free_ranges[at].offset < offset)
+            at++;
+        if (!rcompute__range_insert(block, at, offset, aligned))
+            return;
+        if (at + 1 < block->free_count &&
+            block->free_ranges[at].offset + block->free_ranges[at].size == block->free_ranges[at + 1].offset)
+        {
+            block->free_ranges[at].size += block->free_ranges[at + 1].size;
+            memmove(&block->free_ranges[at + 1], &block->free_ranges[at + 2], (block->free_count - at - 2) * sizeof(rcompute__range));
+            block->free_count--;
+        }
+        if (at > 0 &&
+            block->free_ranges[at - 1].offset + block->free_ranges[at - 1].size == block->free_ranges[at].offset)
+        {
+            block->free_ranges[at - 1].size += block->free_ranges[at].size;
+            memmove(&block->free_ranges[at], &block->free_ranges[at + 1], (block->free_count - at - 1) * sizeof(rcompute__range));
+            block->free_count--;
+        }
+        break;
+    }
+
+    pool->allocations--;
+    pool->used -= aligned;
+}
+
+void rcompute_pool_get_stats(rcompute_pool *pool, rcompute_pool_stats *stats)
+{
+    if (!stats)
+        return;
+    memset(stats, 0, sizeof(*stats));
+    if (!pool)
+        return;
+
+    stats->blocks = pool->block_count;
+    stats->allocations = pool->allocations;
+    stats->used_bytes = pool->used;
+    for (int b = 0; b < pool->block_count; b++)
+    {
+        stats->reserved_bytes += pool->blocks[b].size;
+        stats->free_ranges += pool->blocks[b].free_count;
+        for (int r = 0; r < pool->blocks[b].free_count; r++)
+        {
+            GLsizeiptr size = pool->blocks[b].free_ranges[r].size;
+            stats->free_bytes += size;
+            if (size > stats->largest_free)
+                stats->largest_free = size;
+        }
+    }
+    if (stats->free_bytes > 0)
+        stats->fragmentation = 1.0f - (float)stats->largest_free / (float)stats->free_bytes;
+}
+
+void rcompute_pool_destroy(rcompute_pool *pool)
+{
+    if (!pool)
+        return;
+
+    // Drop any slices still registered against this pool
+    for (int i = 0; i < rcompute__object_cap; i++)
+    {
+        while (rcompute__objects[i].name && rcompute__objects[i].kind == RCOMPUTE__OBJ_SLICE &&
+               rcompute__objects[i].pool == pool)
+            rcompute__untrack(rcompute__objects[i].name, RCOMPUTE__OBJ_SLICE);
+    }
+
+    for (int b = 0; b < pool->block_count; b++)
+    {
+        rcompute__untrack(pool->blocks[b].buffer, RCOMPUTE__OBJ_BUFFER);
+        glDeleteBuffers(1, &pool->blocks[b].buffer);
+        free(pool->blocks[b].free_ranges);
+    }
+    free(pool->blocks);
+    free(pool);
+}
+
+// ---------------------------------
+// Transient arena
+// ---------------------------------
+typedef struct
+{
+    GLuint texture;
+    int width;
+    int height;
+    GLenum format;
+    int in_use;
+} rcompute__arena_texture;
+
+typedef struct
+{
+    GLuint buffer;
+    GLsizeiptr size;
+    GLsizeiptr head;
+    GLsizeiptr used;     // total this iteration, including spilled buffers
+    GLuint *spilled;     // full buffers retired this iteration
+    int spilled_count;
+    GLuint *slices;
+    int slice_count;
+    int slice_cap;
+    rcompute__arena_texture *textures;
+    int texture_count;
+    GLsync fence;
+} rcompute__arena_frame;
+
+struct rcompute_arena
+{
+    GLsizeiptr frame_size;
+    GLsizeiptr align;
+    int frame;
+    int active;
+    long long gl_allocations;
+    rcompute__arena_frame frames[RCOMPUTE_ARENA_FRAMES];
+};
+
+static GLuint rcompute__arena_new_buffer(rcompute_arena *a, GLsizeiptr size)
+{
+    GLuint buf = 0;
+    glGenBuffers(1, &buf);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, size, NULL, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    rcompute__track(buf, RCOMPUTE__OBJ_BUFFER, size, RCOMPUTE__USAGE_INTERNAL, "rcompute arena", NULL, 0);
+    a->gl_allocations++;
+    return buf;
+}
+
+static void rcompute__arena_delete_buffer(GLuint buf)
+{
+    if (buf == 0)
+        return;
+    rcompute__untrack(buf, RCOMPUTE__OBJ_BUFFER);
+    glDeleteBuffers(1, &buf);
+}
+
+rcompute_arena *rcompute_arena_create(GLsizeiptr frame_size)
+{
+    if (frame_size < 0)
+    {
+        rcompute__err("Arena frame size must not be negative");
+        return NULL;
+    }
+
+    rcompute_arena *a = (rcompute_arena *)calloc(1, sizeof(rcompute_arena));
+    if (!a)
+    {
+        rcompute__err("Failed to allocate arena");
+        return NULL;
+    }
+
+    GLint align = 256;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &align);
+    a->align = align > 0 ? align : 256;
+    a->frame_size = (frame_size + a->align - 1) / a->align * a->align;
+    a->frame = RCOMPUTE_ARENA_FRAMES - 1; // first begin lands on frame 0
+
+    // frame_size 0 (texture-only arenas) defers buffer creation to the first allocation
+    for (int i = 0; i < RCOMPUTE_ARENA_FRAMES && a->frame_size > 0; i++)
+    {
+        a->frames[i].buffer = rcompute__arena_new_buffer(a, a->frame_size);
+        a->frames[i].size = a->frame_size;
+    }
+    return a;
+}
+
+void rcompute_arena_begin(rcompute_arena *a)
+{
+    if (!a)
+        return;
+    if (a->active)
+        rcompute_arena_end(a);
+
+    a->frame = (a->frame + 1) % RCOMPUTE_ARENA_FRAMES;
+    rcompute__arena_frame *f = &a->frames[a->frame];
+
+    // The GPU may still be using this frame's ranges from RCOMPUTE_ARENA_FRAMES iterations ago
+    if (f->fence)
+    {
+        GLenum res = glClientWaitSync(f->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (res == GL_TIMEOUT_EXPIRED)
+        {
+            rcompute__debug_log("Arena stalled on frame %d", a->frame);
+            res = glClientWaitSync(f->fence, GL_SYNC_FLUSH_COMMANDS_BIT, (GLuint64)-1);
+        }
+        if (res == GL_WAIT_FAILED)
+            rcompute__err("Arena fence wait failed");
+        glDeleteSync(f->fence);
+        f->fence = NULL;
+    }
+
+    for (int i = 0; i < f->slice_count; i++)
+        rcompute__untrack(f->slices[i], RCOMPUTE__OBJ_SLICE);
+    f->slice_count = 0;
+
+    // Last use of this frame spilled: replace its buffers with one that fits everything
+    if (f->spilled_count > 0)
+    {
+        for (int i = 0; i < f->spilled_count; i++)
+            rcompute__arena_delete_buffer(f->spilled[i]);
+        free(f->spilled);
+        f->spilled = NULL;
+        f->spilled_count = 0;
+        rcompute__arena_delete_buffer(f->buffer);
+
+        GLsizeiptr size = (f->used + a->align - 1) / a->align * a->align;
+        if (size < a->frame_size)
+            size = a->frame_size;
+        f->buffer = rcompute__arena_new_buffer(a, size);
+        f->size = size;
+        rcompute__debug_log("Arena frame %d resized to %lld bytes", a->frame, (long long)size);
+    }
+
+    f->head = 0;
+    f->used = 0;
+    for (int i = 0; i < f->texture_count; i++)
+        f->textures[i].in_use = 0;
+    a->active = 1;
+}
+
+GLuint rcompute_arena_buffer(rcompute_arena *a, GLsizeiptr size)
+{
+    if (!a || size <= 0)
+    {
+        rcompute__err("Invalid arena allocation");
+        return 0;
+    }
+    if (!a->active)
+        rcompute_arena_begin(a);
+
+    rcompute__arena_frame *f = &a->frames[a->frame];
+    if (f->slice_count == f->slice_cap)
+    {
+        int new_cap = f->slice_cap ? f->slice_cap * 2 : 16;
+        GLuint *slices = (GLuint *)realloc(f->slices, new_cap * sizeof(GLuint));
+        if (!slices)
+        {
+            rcompute__err("Failed to grow arena");
+            return 0;
+        }
+        f->slices = slices;
+        f->slice_cap = new_cap;
+    }
+
+    GLsizeiptr aligned = (size + a->align - 1) / a->align * a->align;
+    GLsizeiptr off = (f->head + a->align - 1) / a->align * a->align;
+    if (off + size > f->size)
+    {
+        // Spill: keep the full buffer alive until this frame comes round again
+        if (f->buffer)
+        {
+            GLuint *spilled = (GLuint *)realloc(f->spilled, (f->spilled_count + 1) * sizeof(GLuint));
+            if (!spilled)
+            {
+                rcompute__err("Failed to grow arena");
+                return 0;
+            }
+            f->spilled = spilled;
+            f->spilled[f->spilled_count++] = f->buffer;
+            rcompute__debug_log("Arena frame %d overflowed; spilled into a new buffer", a->frame);
+        }
+        f->size = aligned > a->frame_size ? aligned : a->frame_size;
+        f->buffer = rcompute__arena_new_buffer(a, f->size);
+        off = 0;
+    }
+
+    GLuint handle = RCOMPUTE_SLICE_BIT | rcompute__next_slice++;
+    if (rcompute__next_slice >= RCOMPUTE_SLICE_BIT)
+        rcompute__next_slice = 1;
+    rcompute__track(handle, RCOMPUTE__OBJ_SLICE, size, RCOMPUTE_DYNAMIC, "rcompute arena", NULL, 0);
+    rcompute__object *obj = rcompute__object_find(handle, RCOMPUTE__OBJ_SLICE);
+    if (!obj)
+    {
+        rcompute__err("Failed to register arena slice");
+        return 0;
+    }
+    obj->parent = f->buffer;
+    obj->offset = off;
+    obj->pool = NULL;
+
+    f->slices[f->slice_count++] = handle;
+    f->head = off + size;
+    f->used += aligned;
+    return handle;
+}
+
+GLuint rcompute_arena_texture_2d(rcompute_arena *a, int width, int height, GLenum format)
+{
+    if (!a || width <= 0 || height <= 0)
+    {
+        rcompute__err("Invalid arena texture");
+        return 0;
+    }
+    if (!a->active)
+        rcompute_arena_begin(a);
+
+    rcompute__arena_frame *f = &a->frames[a->frame];
+    for (int i = 0; i < f->texture_count; i++)
+    {
+        rcompute__arena_texture *t = &f->textures[i];
+        if (!t->in_use && t->width == width && t->height == height && t->format == format)
+        {
+            t->in_use = 1;
+            return t->texture;
+        }
+    }
+
+    rcompute__arena_texture *textures = (rcompute__arena_texture *)realloc(
+        f->textures, (f->texture_count + 1) * sizeof(rcompute__arena_texture));
+    if (!textures)
+    {
+        rcompute__err("Failed to grow arena");
+        return 0;
+    }
+    f->textures = textures;
+
+    GLuint tex = rcompute_texture_2d(width, height, format, NULL);
+    if (!tex)
+        return 0;
+    rcompute_texture_label(tex, "rcompute arena");
+    a->gl_allocations++;
+
+    rcompute__arena_texture *t = &f->textures[f->texture_count++];
+    t->texture = tex;
+    t->width = width;
+    t->height = height;
+    t->format = format;
+    t->in_use = 1;
+    return tex;
+}
+
+void rcompute_arena_end(rcompute_arena *a)
+{
+    if (!a || !a->active)
+        return;
+
+    rcompute__arena_frame *f = &a->frames[a->frame];
+    f->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    a->active = 0;
+}
+
+void rcompute_arena_get_stats(rcompute_arena *a, rcompute_arena_stats *stats)
+{
+    if (!stats)
+        return;
+    memset(stats, 0, sizeof(*stats));
+    if (!a)
+        return;
+
+    stats->gl_allocations = a->gl_allocations;
+    if (a->active)
+        stats->frame_bytes = a->frames[a->frame].used;
+    for (int i = 0; i < RCOMPUTE_ARENA_FRAMES; i++)
+    {
+        const rcompute__arena_frame *f = &a->frames[i];
+        stats->reserved_bytes += f->size;
+        for (int j = 0; j < f->spilled_count; j++)
+            stats->reserved_bytes += rcompute_buffer_size(f->spilled[j]);
+        stats->textures += f->texture_count;
+    }
+}
+
+void rcompute_arena_destroy(rcompute_arena *a)
+{
+    if (!a)
+        return;
+
+    for (int i = 0; i < RCOMPUTE_ARENA_FRAMES; i++)
+    {
+        rcompute__arena_frame *f = &a->frames[i];
+        if (f->fence)
+            glDeleteSync(f->fence);
+        for (int j = 0; j < f->slice_count; j++)
+            rcompute__untrack(f->slices[j], RCOMPUTE__OBJ_SLICE);
+        for (int j = 0; j < f->spilled_count; j++)
+            rcompute__arena_delete_buffer(f->spilled[j]);
+        for (int j = 0; j < f->texture_count; j++)
+            rcompute_texture_destroy(f->textures[j].texture);
+        rcompute__arena_delete_buffer(f->buffer);
+        free(f->spilled);
+        free(f->slices);
+        free(f->textures);
+    }
+    free(a);
+}
+
+// ---------------------------------
+// Streaming upload ring
+// ---------------------------------
+int rcompute_ring_create(rcompute_ring *r, GLsizeiptr size, int coherent)
+{
+    if (!r)
+        return 0;
+    memset(r, 0, sizeof(*r));
+
+    if (size < RCOMPUTE_RING_SEGMENTS)
+    {
+        rcompute__err("Ring size too small");
+        return 0;
+    }
+    if (!rcompute_check_version(4, 4) && !rcompute__has_gl_extension("GL_ARB_buffer_storage"))
+    {
+        rcompute__err("Upload ring requires GL 4.4 or GL_ARB_buffer_storage");
+        return 0;
+    }
+
+    GLbitfield storage_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
+    GLbitfield map_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
+    if (coherent)
+    {
+        storage_flags |= GL_MAP_COHERENT_BIT;
+        map_flags |= GL_MAP_COHERENT_BIT;
+    }
+    else
+    {
+        map_flags |= GL_MAP_FLUSH_EXPLICIT_BIT;
+    }
+
+    glGenBuffers(1, &r->buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, r->buffer);
+    glBufferStorage(GL_SHADER_STORAGE_BUFFER, size, NULL, storage_flags);
+    r->ptr = (unsigned char *)glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, size, map_flags);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+    if (!r->ptr)
+    {
+        rcompute__err("Failed to map upload ring");
+        glDeleteBuffers(1, &r->buffer);
+        r->buffer = 0;
+        return 0;
+    }
+
+    r->size = size;
+    r->coherent = coherent;
+    rcompute__track(r->buffer, RCOMPUTE__OBJ_BUFFER, size, RCOMPUTE_STREAM, "rcompute ring", NULL, 0);
+    rcompute__object *obj = rcompute__object_find(r->buffer, RCOMPUTE__OBJ_BUFFER);
+    if (obj)
+        obj->persistent = 1;
+    rcompute__debug_log("Upload ring created: %lld bytes (%s)", (long long)size, coherent ? "coherent" : "explicit flush");
+    return 1;
+}
+
+static void rcompute__ring_enter(rcompute_ring *r, int seg)
+{
+    // Segment still fenced from the previous lap: wait for the GPU to finish reading it
+    if (!r->fences[seg] && (r->touched & (1u << seg)))
+    {
+        // Lapped without rcompute_ring_fence; fence now so the wait covers all prior work
+        r->fences[seg] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        rcompute__debug_log("Upload ring lapped without rcompute_ring_fence");
+    }
+    if (r->fences[seg])
+    {
+        GLenum res = glClientWaitSync(r->fences[seg], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (res == GL_TIMEOUT_EXPIRED)
+        {
+            rcompute__debug_log("Upload ring stalled on segment %d", seg);
+            res = glClientWaitSync(r->fences[seg], GL_SYNC_FLUSH_COMMANDS_BIT, (GLuint64)-1);
+        }
+        if (res == GL_WAIT_FAILED)
+            rcompute__err("Upload ring fence wait failed");
+        glDeleteSync(r->fences[seg]);
+        r->fences[seg] = NULL;
+    }
+    r->touched |= 1u << seg;
+}
+
+void *rcompute_ring_alloc(rcompute_ring *r, GLsizeiptr size, GLsizeiptr align, GLsizeiptr *offset)
+{
+    if (!r || !r->ptr || size <= 0 || size > r->size)
+    {
+        rcompute__err("Invalid ring allocation");
+        return NULL;
+    }
+
+    if (align <= 0)
+    {
+        GLint a = 256;
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &a);
+        align = a;
+    }
+
+    GLsizeiptr seg_size = r->size / RCOMPUTE_RING_SEGMENTS;
+    GLsizeiptr off = (r->head + align - 1) / align * align;
+    int wrapped = 0;
+    if (off + size > r->size)
+    {
+        off = 0;
+        wrapped = 1;
+    }
+
+    int first = (int)(off / seg_size);
+    int last = (int)((off + size - 1) / seg_size);
+    if (first >= RCOMPUTE_RING_SEGMENTS) first = RCOMPUTE_RING_SEGMENTS - 1;
+    if (last >= RCOMPUTE_RING_SEGMENTS) last = RCOMPUTE_RING_SEGMENTS - 1;
+
+    for (int seg = first; seg <= last; seg++)
+    {
+        if (wrapped || seg != r->current_segment)
+            rcompute__ring_enter(r, seg);
+    }
+
+    r->current_segment = last;
+    r->head = off + size;
+    if (offset)
+        *offset = off;
+    return r->ptr + off;
+}
+
+void rcompute_ring_flush(rcompute_ring *r, GLsizeiptr offset, GLsizeiptr size)
+{
+    if (!r || !r->buffer || r->coherent)
+        return;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, r->buffer);
+    glFlushMappedBufferRange(GL_SHADER_STORAGE_BUFFER, offset, size);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void rcompute_ring_copy(rcompute_ring *r, GLsizeiptr offset, GLuint dst, GLsizeiptr dst_offset, GLsizeiptr size)
+{
+    if (!r || !r->buffer || dst == 0 || size <= 0)
+    {
+        rcompute__err("Invalid ring copy parameters");
+        return;
+    }
+
+    GLsizeiptr base, known_size;
+    dst = rcompute__resolve_buffer(dst, &base, &known_size);
+    dst_offset += base;
+
+    rcompute__buffer_hazard(dst, GL_BUFFER_UPDATE_BARRIER_BIT);
+    int ev = rcompute__prof_begin("upload", "ring copy", size);
+    glBindBuffer(GL_COPY_READ_BUFFER, r->buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, dst);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset, dst_offset, size);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    rcompute__prof_end(ev);
+}
+
+void rcompute_ring_bind(rcompute_ring *r, GLuint binding, GLsizeiptr offset, GLsizeiptr size)
+{
+    if (!r || !r->buffer || size <= 0)
+    {
+        rcompute__err("Invalid ring bind parameters");
+        return;
+    }
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, r->buffer, offset, size);
+    rcompute__note_binding(0, binding, r->buffer, size);
+}
+
+void rcompute_ring_fence(rcompute_ring *r)
+{
+    if (!r || !r->buffer || !r->touched)
+        return;
+
+    for (int seg = 0; seg < RCOMPUTE_RING_SEGMENTS; seg++)
+    {
+        if (!(r->touched & (1u << seg)))
+            continue;
+        if (r->fences[seg])
+            glDeleteSync(r->fences[seg]); // superseded by the newer fence
+        r->fences[seg] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    // The current segment keeps being written until the head moves on
+    r->touched = 1u << r->current_segment;
+}
+
+void rcompute_ring_destroy(rcompute_ring *r)
+{
+    if (!r)
+        return;
+
+    for (int seg = 0; seg < RCOMPUTE_RING_SEGMENTS; seg++)
+    {
+        if (r->fences[seg])
+            glDeleteSync(r->fences[seg]);
+        r->fences[seg] = NULL;
+    }
+
+    if (r->buffer)
+    {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, r->buffer);
+        glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        rcompute__untrack(r->buffer, RCOMPUTE__OBJ_BUFFER);
+        glDeleteBuffers(1, &r->buffer);
+    }
+    memset(r, 0, sizeof(*r));
+}
+
+// ---------------------------------
+// Async buffer operations
+// ---------------------------------
+static rcompute__readback *rcompute__readback_get(rcompute_ticket ticket)
+{
+    int index = (int)(ticket & 0xFFFF) - 1;
+    if (ticket == 0 || index < 0 || index >= rcompute__readback_count)
+        return NULL;
+    rcompute__readback *rb = &rcompute__readbacks[index];
+    if (!rb->fence || rb->gen != (ticket >> 16))
+        return NULL;
+    return rb;
+}
+
+static int rcompute__readback_slot(GLsizeiptr size)
+{
+    // Prefer a free slot whose staging buffer is already big enough
+    int free_slot = -1;
+    for (int i = 0; i < rcompute__readback_count; i++)
+    {
+        if (rcompute__readbacks[i].fence)
+            continue;
+        if (rcompute__readbacks[i].capacity >= size)
+            return i;
+        if (free_slot < 0)
+            free_slot = i;
+    }
+    if (free_slot >= 0)
+        return free_slot;
+
+    if (rcompute__readback_count >= 0xFFFF)
+        return -1;
+    rcompute__readback *p = (rcompute__readback *)realloc(
+        rcompute__readbacks, (rcompute__readback_count + 1) * sizeof(rcompute__readback));
+    if (!p)
+        return -1;
+    rcompute__readbacks = p;
+    memset(&rcompute__readbacks[rcompute__readback_count], 0, sizeof(rcompute__readback));
+    return rcompute__readback_count++;
+}
+
+static void rcompute__readback_free_staging(rcompute__readback *rb)
+{
+    if (!rb->staging)
+        return;
+    if (rb->mapped)
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, rb->staging);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    rcompute__untrack(rb->staging, RCOMPUTE__OBJ_BUFFER);
+    glDeleteBuffers(1, &rb->staging);
+    rb->staging = 0;
+    rb->mapped = NULL;
+    rb->capacity = 0;
+}
+
+rcompute_ticket rcompute_readback(GLuint buf, GLsizeiptr offset, GLsizeiptr size)
+{
+    if (buf == 0 || size <= 0 || offset < 0)
+    {
+        rcompute__err("Invalid readback parameters");
+        return 0;
+    }
+
+    int index = rcompute__readback_slot(size);
+    if (index < 0)
+    {
+        rcompute__err("Too many readbacks in flight");
+        return 0;
+    }
+    rcompute__readback *rb = &rcompute__readbacks[index];
+
+    if (rb->capacity < size)
+    {
+        rcompute__readback_free_staging(rb);
+        glGenBuffers(1, &rb->staging);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, rb->staging);
+        if (rcompute__has_buffer_storage())
+        {
+            GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_COPY_WRITE_BUFFER, size, NULL, flags);
+            rb->mapped = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags);
+        }
+        else
+        {
+            glBufferData(GL_COPY_WRITE_BUFFER, size, NULL, GL_STREAM_READ);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        rb->capacity = size;
+        rcompute__track(rb->staging, RCOMPUTE__OBJ_BUFFER, size, RCOMPUTE__USAGE_INTERNAL, "rcompute readback", NULL, 0);
+    }
+
+    GLsizeiptr base, known_size;
+    buf = rcompute__resolve_buffer(buf, &base, &known_size);
+    offset += base;
+
+    // Make shader writes visible to the copy, then copy on the GPU; the CPU never waits here
+    rcompute__buffer_hazard(buf, GL_BUFFER_UPDATE_BARRIER_BIT);
+    int ev = rcompute__prof_begin("readback", "readback copy", size);
+    glBindBuffer(GL_COPY_READ_BUFFER, buf);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, rb->staging);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset, 0, size);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    rcompute__prof_end(ev);
+
+    rb->size = size;
+    rb->legacy_dest = NULL;
+    rb->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush(); // make sure the fence can signal without us waiting on it
+
+    rcompute__debug_log("Readback queued: %lld bytes at offset %lld (slot %d)", (long long)size, (long long)offset, index);
+    return (rb->gen << 16) | (rcompute_ticket)(index + 1);
+}
+
+int rcompute_readback_ready(rcompute_ticket ticket)
+{
+    rcompute__readback *rb = rcompute__readback_get(ticket);
+    if (!rb)
+        return 0;
+    GLint status = GL_UNSIGNALED;
+    glGetSynciv(rb->fence, GL_SYNC_STATUS, 1, NULL, &status);
+    return status == GL_SIGNALED;
+}
+
+int rcompute_readback_wait(rcompute_ticket ticket, void *out)
+{
+    rcompute__readback *rb = rcompute__readback_get(ticket);
+    if (!rb)
+    {
+        rcompute__err("Invalid readback ticket");
+        return 0;
+    }
+
+    int ok = 1;
+    int ev = rcompute__prof_begin("readback", "readback wait", rb->size);
+    GLenum result = glClientWaitSync(rb->fence, GL_SYNC_FLUSH_COMMANDS_BIT, (GLuint64)-1);
+    if (result == GL_WAIT_FAILED)
+    {
+        rcompute__err("Async wait failed");
+        ok = 0;
+    }
+
+    if (ok && out)
+    {
+        if (rb->mapped)
+        {
+            memcpy(out, rb->mapped, rb->size);
+        }
+        else
+        {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, rb->staging);
+            void *ptr = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, rb->size, GL_MAP_READ_BIT);
+            if (ptr)
+            {
+                memcpy(out, ptr, rb->size);
+                glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            }
+            else
+            {
+                rcompute__err("Failed to map readback staging buffer");
+                ok = 0;
+            }
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+    }
+
+    rcompute__prof_end(ev);
+
+    glDeleteSync(rb->fence);
+    rb->fence = NULL;
+    rb->legacy_dest = NULL;
+    rb->gen = (rb->gen + 1) & 0xFFFF;
+    return ok;
+}
+
+void rcompute_read_async(GLuint buf, void *data, size_t size, size_t offset)
+{
+    if (buf == 0 || !data)
+    {
+        rcompute__err("Invalid buffer handle");
+        return;
+    }
+
+    rcompute_ticket ticket = rcompute_readback(buf, (GLsizeiptr)offset, (GLsizeiptr)size);
+    rcompute__readback *rb = rcompute__readback_get(ticket);
+    if (rb)
+        rb->legacy_dest = data;
+}
+
+void rcompute_wait_async()
+{
+    int waited = 0;
+    for (int i = 0; i < rcompute__readback_count; i++)
+    {
+        rcompute__readback *rb = &rcompute__readbacks[i];
+        if (!rb->fence || !rb->legacy_dest)
+            continue;
+        rcompute_readback_wait((rb->gen << 16) | (rcompute_ticket)(i + 1), rb->legacy_dest);
+        waited++;
+    }
+
+    if (!waited)
+        rcompute__debug_log("No async operation to wait for");
+    else
+        rcompute__debug_log("Async operation completed");
+}
+
+// ---------------------------------
+void rcompute_buffer_bind(GLuint buf, GLuint binding)
+{
+    if (buf == 0)
+    {
+        rcompute__err("Invalid buffer handle");
+        return;
+    }
+    if (buf & RCOMPUTE_SLICE_BIT)
+    {
+        GLsizeiptr base, size;
+        GLuint gl_buf = rcompute__resolve_buffer(buf, &base, &size);
+        if (!gl_buf)
+        {
+            rcompute__err("Invalid slice handle");
+            return;
+        }
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, gl_buf, base, size);
+        rcompute__note_binding(0, binding, gl_buf, size);
+        return;
+    }
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buf);
+    rcompute__note_binding(0, binding, buf, 0);
+}
+
+// ---------------------------------
+void rcompute_buffer_destroy(GLuint buf)
+{
+    if (buf & RCOMPUTE_SLICE_BIT)
+    {
+        // arena slices (no pool) are recycled by their arena
+        rcompute__object *obj = rcompute__object_find(buf, RCOMPUTE__OBJ_SLICE);
+        if (obj && obj->pool)
+            rcompute_pool_free(obj->pool, buf);
+        return;
+    }
+    if (buf != 0)
+    {
+        rcompute__untrack(buf, RCOMPUTE__OBJ_BUFFER);
+        glDeleteBuffers(1, &buf);
     }
-    c->program = program;
 }
 
 // ---------------------------------
-// Uniform helpers
+GLsizeiptr rcompute_buffer_size(GLuint buf)
+{
+    if (buf == 0)
+    {
+        rcompute__err("Invalid buffer handle");
+        return 0;
+    }
+
+    rcompute__object *obj = rcompute__object_find(buf, (buf & RCOMPUTE_SLICE_BIT) ? RCOMPUTE__OBJ_SLICE : RCOMPUTE__OBJ_BUFFER);
+    if (obj)
+        return obj->size;
+    if (buf & RCOMPUTE_SLICE_BIT)
+    {
+        rcompute__err("Invalid slice handle");
+        return 0;
+    }
+
+    // Not created through rcompute: ask the driver
+    GLint size = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
+    glGetBufferParameteriv(GL_SHADER_STORAGE_BUFFER, GL_BUFFER_SIZE, &size);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return (GLsizeiptr)size;
+}
+
 // ---------------------------------
-void rcompute_set_uniform_int(rcompute *c, const char *name, int value)
+// Buffer mapping for large transfers
+// ---------------------------------
+void *rcompute_buffer_map(GLuint buf, GLenum access)
 {
-    if (!c || !name) return;
-    if (c->last_program != c->program) {
-        glUseProgram(c->program);
-        c->last_program = c->program;
+    if (buf == 0)
+    {
+        rcompute__err("Invalid buffer handle");
+        return NULL;
+    }
+
+    void *ptr;
+    if (buf & RCOMPUTE_SLICE_BIT)
+    {
+        GLsizeiptr base, size;
+        GLuint gl_buf = rcompute__resolve_buffer(buf, &base, &size);
+        GLbitfield bits = access == GL_READ_ONLY ? GL_MAP_READ_BIT
+                        : access == GL_WRITE_ONLY ? GL_MAP_WRITE_BIT
+                                                  : (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT);
+        rcompute__buffer_hazard(gl_buf, GL_BUFFER_UPDATE_BARRIER_BIT);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, gl_buf);
+        ptr = gl_buf ? glMapBufferRange(GL_SHADER_STORAGE_BUFFER, base, size, bits) : NULL;
+    }
+    else
+    {
+        rcompute__buffer_hazard(buf, GL_BUFFER_UPDATE_BARRIER_BIT);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
+        ptr = glMapBuffer(GL_SHADER_STORAGE_BUFFER, access);
+    }
+    if (!ptr)
+    {
+        rcompute__err("Failed to map buffer");
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        return NULL;
     }
-    GLint loc = glGetUniformLocation(c->program, name);
-    if (loc != -1) glUniform1i(loc, value);
+    
+    rcompute__debug_log("Buffer mapped");
+    return ptr;
 }
 
-void rcompute_set_uniform_uint(rcompute *c, const char *name, unsigned int value)
+void rcompute_buffer_unmap(GLuint buf)
 {
-    if (!c || !name) return;
-    if (c->last_program != c->program) {
-        glUseProgram(c->program);
-        c->last_program = c->program;
+    if (buf == 0)
+    {
+        rcompute__err("Invalid buffer handle");
+        return;
     }
-    GLint loc = glGetUniformLocation(c->program, name);
-    if (loc != -1) glUniform1ui(loc, value);
+
+    GLsizeiptr base, size;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, rcompute__resolve_buffer(buf, &base, &size));
+    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    
+    rcompute__debug_log("Buffer unmapped");
 }
 
-void rcompute_set_uniform_float(rcompute *c, const char *name, float value)
+// ---------------------------------
+// Texture operations
+// ---------------------------------
+GLuint rcompute_texture_2d(int width, int height, GLenum format, const void *data)
 {
-    if (!c || !name) return;
-    if (c->last_program != c->program) {
-        glUseProgram(c->program);
-        c->last_program = c->program;
+    return rcompute_texture_2d_tracked(width, height, format, data, NULL, 0);
+}
+
+GLuint rcompute_texture_2d_tracked(int width, int height, GLenum format, const void *data, const char *file, int line)
+{
+    if (width <= 0 || height <= 0)
+    {
+        rcompute__err("Invalid texture dimensions");
+        return 0;
+    }
+
+    GLuint tex;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+
+    // Set texture parameters
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // Determine internal format and type
+    GLenum internal_format = format;
+    GLenum type = GL_UNSIGNED_BYTE;
+    GLenum base_format = format;
+
+    if (format == GL_R32F || format == GL_RG32F || format == GL_RGBA32F)
+    {
+        type = GL_FLOAT;
+        if (format == GL_R32F) base_format = GL_RED;
+        else if (format == GL_RG32F) base_format = GL_RG;
+        else base_format = GL_RGBA;
+    }
+    else if (format == GL_R32I || format == GL_RG32I || format == GL_RGBA32I)
+    {
+        type = GL_INT;
+        if (format == GL_R32I) base_format = GL_RED_INTEGER;
+        else if (format == GL_RG32I) base_format = GL_RG_INTEGER;
+        else base_format = GL_RGBA_INTEGER;
+    }
+    else if (format == GL_R32UI || format == GL_RG32UI || format == GL_RGBA32UI)
+    {
+        type = GL_UNSIGNED_INT;
+        if (format == GL_R32UI) base_format = GL_RED_INTEGER;
+        else if (format == GL_RG32UI) base_format = GL_RG_INTEGER;
+        else base_format = GL_RGBA_INTEGER;
     }
-    GLint loc = glGetUniformLocation(c->program, name);
-    if (loc != -1) glUniform1f(loc, value);
+
+    int ev = data ? rcompute__prof_begin("upload", "texture 2D",
+                                         (long long)width * height * rcompute__texel_size(format)) : -1;
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, base_format, type, data);
+    rcompute__prof_end(ev);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    rcompute__track(tex, RCOMPUTE__OBJ_TEXTURE, (GLsizeiptr)width * height * rcompute__texel_size(format),
+                    RCOMPUTE__USAGE_INTERNAL, NULL, file, line);
+    rcompute__debug_log("2D texture created: %dx%d format=%d", width, height, format);
+    return tex;
 }
 
-void rcompute_set_uniform_vec2(rcompute *c, const char *name, float x, float y)
+GLuint rcompute_texture_3d(int width, int height, int depth, GLenum format, const void *data)
 {
-    if (!c || !name) return;
-    if (c->last_program != c->program) {
-        glUseProgram(c->program);
-        c->last_program = c->program;
+    return rcompute_texture_3d_tracked(width, height, depth, format, data, NULL, 0);
+}
+
+GLuint rcompute_texture_3d_tracked(int width, int height, int depth, GLenum format, const void *data, const char *file, int line)
+{
+    if (width <= 0 || height <= 0 || depth <= 0)
+    {
+        rcompute__err("Invalid texture dimensions");
+        return 0;
+    }
+
+    GLuint tex;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_3D, tex);
+
+    // Set texture parameters
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    // Determine internal format and type
+    GLenum internal_format = format;
+    GLenum type = GL_UNSIGNED_BYTE;
+    GLenum base_format = format;
+
+    if (format == GL_R32F || format == GL_RG32F || format == GL_RGBA32F)
+    {
+        type = GL_FLOAT;
+        if (format == GL_R32F) base_format = GL_RED;
+        else if (format == GL_RG32F) base_format = GL_RG;
+        else base_format = GL_RGBA;
+    }
+    else if (format == GL_R32I || format == GL_RG32I || format == GL_RGBA32I)
+    {
+        type = GL_INT;
+        if (format == GL_R32I) base_format = GL_RED_INTEGER;
+        else if (format == GL_RG32I) base_format = GL_RG_INTEGER;
+        else base_format = GL_RGBA_INTEGER;
+    }
+    else if (format == GL_R32UI || format == GL_RG32UI || format == GL_RGBA32UI)
+    {
+        type = GL_UNSIGNED_INT;
+        if (format == GL_R32UI) base_format = GL_RED_INTEGER;
+        else if (format == GL_RG32UI) base_format = GL_RG_INTEGER;
+        else base_format = GL_RGBA_INTEGER;
     }
-    GLint loc = glGetUniformLocation(c->program, name);
-    if (loc != -1) glUniform2f(loc, x, y);
+
+    int ev = data ? rcompute__prof_begin("upload", "texture 3D",
+                                         (long long)width * height * depth * rcompute__texel_size(format)) : -1;
+    glTexImage3D(GL_TEXTURE_3D, 0, internal_format, width, height, depth, 0, base_format, type, data);
+    rcompute__prof_end(ev);
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    rcompute__track(tex, RCOMPUTE__OBJ_TEXTURE, (GLsizeiptr)width * height * depth * rcompute__texel_size(format),
+                    RCOMPUTE__USAGE_INTERNAL, NULL, file, line);
+    rcompute__debug_log("3D texture created: %dx%dx%d format=%d", width, height, depth, format);
+    return tex;
 }
 
-void rcompute_set_uniform_vec3(rcompute *c, const char *name, float x, float y, float z)
+void rcompute_texture_bind(GLuint tex, GLuint unit, GLenum format)
 {
-    if (!c || !name) return;
-    if (c->last_program != c->program) {
-        glUseProgram(c->program);
-        c->last_program = c->program;
+    if (tex == 0)
+    {
+        rcompute__err("Invalid texture handle");
+        return;
+    }
+    glBindImageTexture(unit, tex, 0, GL_FALSE, 0, GL_READ_WRITE, format);
+    rcompute__note_binding(1, unit, tex, 0);
+    rcompute__debug_log("Texture bound to unit %u with format %d", unit, format);
+}
+
+void rcompute_texture_destroy(GLuint tex)
+{
+    if (tex != 0)
+    {
+        rcompute__untrack(tex, RCOMPUTE__OBJ_TEXTURE);
+        glDeleteTextures(1, &tex);
     }
-    GLint loc = glGetUniformLocation(c->program, name);
-    if (loc != -1) glUniform3f(loc, x, y, z);
 }
 
-void rcompute_set_uniform_vec4(rcompute *c, const char *name, float x, float y, float z, float w)
+// ---------------------------------
+// Ping-pong pairs
+// ---------------------------------
+int rcompute_pingpong_buffers(rcompute_pingpong *pp, GLsizeiptr size, const void *data, GLuint read_binding, GLuint write_binding)
 {
-    if (!c || !name) return;
-    if (c->last_program != c->program) {
-        glUseProgram(c->program);
-        c->last_program = c->program;
+    if (!pp || size <= 0 || read_binding == write_binding)
+    {
+        rcompute__err("Invalid ping-pong buffer parameters");
+        return 0;
+    }
+
+    memset(pp, 0, sizeof(*pp));
+    pp->read_binding = read_binding;
+    pp->write_binding = write_binding;
+    for (int i = 0; i < 2; i++)
+    {
+        pp->objects[i] = data ? rcompute_buffer(size, data) : rcompute_buffer_zero(size);
+        if (!pp->objects[i])
+        {
+            rcompute_pingpong_destroy(pp);
+            return 0;
+        }
     }
-    GLint loc = glGetUniformLocation(c->program, name);
-    if (loc != -1) glUniform4f(loc, x, y, z, w);
+    rcompute_pingpong_bind(pp);
+    return 1;
 }
 
-void rcompute_set_uniform_mat4(rcompute *c, const char *name, const float *matrix)
+int rcompute_pingpong_textures(rcompute_pingpong *pp, int width, int height, GLenum format, const void *data,
+                               GLuint read_unit, GLuint write_unit)
 {
-    if (!c || !name || !matrix) return;
-    if (c->last_program != c->program) {
-        glUseProgram(c->program);
-        c->last_program = c->program;
+    if (!pp || width <= 0 || height <= 0 || read_unit == write_unit)
+    {
+        rcompute__err("Invalid ping-pong texture parameters");
+        return 0;
+    }
+
+    memset(pp, 0, sizeof(*pp));
+    pp->is_texture = 1;
+    pp->format = format;
+    pp->read_binding = read_unit;
+    pp->write_binding = write_unit;
+    for (int i = 0; i < 2; i++)
+    {
+        pp->objects[i] = rcompute_texture_2d(width, height, format, data);
+        if (!pp->objects[i])
+        {
+            rcompute_pingpong_destroy(pp);
+            return 0;
+        }
+    }
+    rcompute_pingpong_bind(pp);
+    return 1;
+}
+
+void rcompute_pingpong_bind(rcompute_pingpong *pp)
+{
+    if (!pp || !pp->objects[0])
+        return;
+
+    GLuint front = pp->objects[pp->front];
+    GLuint back = pp->objects[pp->front ^ 1];
+    if (pp->is_texture)
+    {
+        glBindImageTexture(pp->read_binding, front, 0, GL_FALSE, 0, GL_READ_ONLY, pp->format);
+        glBindImageTexture(pp->write_binding, back, 0, GL_FALSE, 0, GL_WRITE_ONLY, pp->format);
+        rcompute__note_binding(1, pp->read_binding, front, 0);
+        rcompute__note_binding(1, pp->write_binding, back, 0);
+    }
+    else
+    {
+        rcompute_buffer_bind(front, pp->read_binding);
+        rcompute_buffer_bind(back, pp->write_binding);
+    }
+}
+
+void rcompute_pingpong_swap(rcompute_pingpong *pp)
+{
+    if (!pp || !pp->objects[0])
+        return;
+
+    // The next dispatch sees the back object as dirty and gets its barrier inferred
+    pp->front ^= 1;
+    rcompute_pingpong_bind(pp);
+}
+
+GLuint rcompute_pingpong_front(const rcompute_pingpong *pp)
+{
+    return pp ? pp->objects[pp->front] : 0;
+}
+
+GLuint rcompute_pingpong_back(const rcompute_pingpong *pp)
+{
+    return pp ? pp->objects[pp->front ^ 1] : 0;
+}
+
+void rcompute_pingpong_destroy(rcompute_pingpong *pp)
+{
+    if (!pp)
+        return;
+
+    for (int i = 0; i < 2; i++)
+    {
+        if (pp->is_texture)
+            rcompute_texture_destroy(pp->objects[i]);
+        else
+            rcompute_buffer_destroy(pp->objects[i]);
+        pp->objects[i] = 0;
     }
-    GLint loc = glGetUniformLocation(c->program, name);
-    if (loc != -1) glUniformMatrix4fv(loc, 1, GL_FALSE, matrix);
 }
 
 // ---------------------------------
-// compile compute shader from file
+// Labels and memory accounting
 // ---------------------------------
-GLuint rcompute_compile_file(const char *filepath)
+void rcompute_buffer_label(GLuint buf, const char *label)
 {
-    if (!filepath)
-    {
-        rcompute__err("Filepath is NULL");
-        return 0;
-    }
+    int kind = (buf & RCOMPUTE_SLICE_BIT) ? RCOMPUTE__OBJ_SLICE : RCOMPUTE__OBJ_BUFFER;
+    rcompute__object *obj = rcompute__object_find(buf, kind);
+    if (obj)
+        snprintf(obj->label, sizeof(obj->label), "%s", label ? label : "");
+    if (buf != 0 && label && kind == RCOMPUTE__OBJ_BUFFER)
+        glObjectLabel(GL_BUFFER, buf, -1, label);
+}
 
-    FILE *f = fopen(filepath, "rb");
-    if (!f)
+void rcompute_program_label(GLuint program, const char *label)
+{
+    int index = rcompute__program_register(program);
+    if (index < 0)
     {
-        rcompute__err_ex("Failed to open shader file: %s", filepath);
-        return 0;
+        rcompute__err("Invalid compute program");
+        return;
     }
+    snprintf(rcompute__programs[index].label, sizeof(rcompute__programs[index].label), "%s", label ? label : "");
+    if (label)
+        glObjectLabel(GL_PROGRAM, program, -1, label);
+}
 
-    fseek(f, 0, SEEK_END);
-    long len = ftell(f);
-    fseek(f, 0, SEEK_SET);
+void rcompute_texture_label(GLuint tex, const char *label)
+{
+    rcompute__object *obj = rcompute__object_find(tex, RCOMPUTE__OBJ_TEXTURE);
+    if (obj)
+        snprintf(obj->label, sizeof(obj->label), "%s", label ? label : "");
+    if (tex != 0 && label)
+        glObjectLabel(GL_TEXTURE, tex, -1, label);
+}
 
-    char *src = (char *)malloc(len + 1);
-    if (!src)
+void rcompute_get_memory_stats(rcompute_memory_stats *stats)
+{
+    if (!stats)
+        return;
+    memset(stats, 0, sizeof(*stats));
+    stats->live_bytes = rcompute__live_bytes;
+    stats->peak_bytes = rcompute__peak_bytes;
+    for (int i = 0; i < rcompute__object_cap; i++)
     {
-        fclose(f);
-        rcompute__err("Failed to allocate memory for shader");
-        return 0;
+        if (!rcompute__objects[i].name)
+            continue;
+        if (rcompute__objects[i].kind == RCOMPUTE__OBJ_BUFFER)
+            stats->live_buffers++;
+        else if (rcompute__objects[i].kind == RCOMPUTE__OBJ_TEXTURE)
+            stats->live_textures++;
     }
+}
 
-    size_t bytes_read = fread(src, 1, len, f);
-    if (bytes_read != (size_t)len)
+static void rcompute__memory_print(FILE *out, const char *prefix)
+{
+    fprintf(out, "%sGPU memory: %lld bytes live, %lld bytes peak, %d objects\n",
+            prefix, rcompute__live_bytes, rcompute__peak_bytes, rcompute__object_count);
+    for (int i = 0; i < rcompute__object_cap; i++)
     {
-        free(src);
-        fclose(f);
-        rcompute__err("Failed to read complete shader file");
-        return 0;
+        const rcompute__object *obj = &rcompute__objects[i];
+        if (!obj->name)
+            continue;
+        fprintf(out, "%s  %s %u: %lld bytes%s%s%s", prefix,
+                obj->kind == RCOMPUTE__OBJ_BUFFER ? "buffer" : obj->kind == RCOMPUTE__OBJ_TEXTURE ? "texture" : "slice",
+                obj->name & ~RCOMPUTE_SLICE_BIT, (long long)obj->size,
+                obj->label[0] ? " \"" : "", obj->label, obj->label[0] ? "\"" : "");
+        if (obj->file)
+            fprintf(out, " (%s:%d)", obj->file, obj->line);
+        fprintf(out, "\n");
     }
-    src[len] = '\0';
-    fclose(f);
-
-    GLuint prog = rcompute_compile(src);
-    free(src);
+}
 
-    return prog;
+void rcompute_memory_report(void)
+{
+    rcompute__memory_print(stdout, "[rcompute] ");
 }
 
 // ---------------------------------
-// Hot-reload shader from file
-// ---------------------------------
-int rcompute_reload_shader(rcompute *c, const char *filepath)
+void rcompute_run(rcompute *c, int nx, int ny, int nz)
 {
-    if (!c || !filepath)
+    if (!c || c->program == 0)
     {
-        rcompute__err("Invalid parameters for reload");
-        return 0;
+        rcompute__err("Invalid compute context or program");
+        return;
+    }
+    if (nx < 0 || ny < 0 || nz < 0)
+    {
+        rcompute__err("Negative work group count");
+        return;
     }
 
-    GLuint old_program = c->program;
-    GLuint new_program = rcompute_compile_file(filepath);
-    
-    if (!new_program)
+    // Only rebind when the context's program actually changed
+    if (c->last_program != c->program)
     {
-        rcompute__err("Failed to reload shader");
-        return 0;
+        glUseProgram(c->program);
+        c->last_program = c->program;
     }
+    rcompute__dispatch(c->program, nx, ny, nz, -1);
+}
 
-    // Delete old program and use new one
-    if (old_program != 0)
-        glDeleteProgram(old_program);
-    
-    c->program = new_program;
-    c->last_program = 0; // Reset cache
-    
-    rcompute__debug_log("Shader reloaded: %s", filepath);
-    return 1;
+// ---------------------------------
+void rcompute_dispatch_1d(rcompute *c, int nx)
+{
+    rcompute_run(c, nx, 1, 1);
 }
 
 // ---------------------------------
-GLuint rcompute_buffer_ex(GLsizeiptr size, const void *data, rcompute_usage usage)
+void rcompute_dispatch_2d(rcompute *c, int nx, int ny)
 {
-    if (size <= 0)
+    rcompute_run(c, nx, ny, 1);
+}
+
+// ---------------------------------
+void rcompute_dispatch_items_3d(rcompute *c, int count_x, int count_y, int count_z)
+{
+    if (!c || c->program == 0 || count_x < 0 || count_y < 0 || count_z < 0)
     {
-        rcompute__err("Buffer size must be positive");
-        return 0;
+        rcompute__err("Invalid compute context or item count");
+        return;
     }
 
-    GLenum gl_usage;
-    switch (usage)
+    int index = rcompute__program_register(c->program);
+    if (index < 0)
     {
-    case RCOMPUTE_STATIC:
-        gl_usage = GL_STATIC_DRAW;
-        break;
-    case RCOMPUTE_STREAM:
-        gl_usage = GL_STREAM_COPY;
-        break;
-    case RCOMPUTE_DYNAMIC:
-    default:
-        gl_usage = GL_DYNAMIC_COPY;
-        break;
+        rcompute__err("Invalid compute program");
+        return;
+    }
+    const GLint *local = rcompute__programs[index].local_size;
+    if (local[0] <= 0 || local[1] <= 0 || local[2] <= 0)
+    {
+        rcompute__err("Program has no compute work group size");
+        return;
     }
 
-    GLuint buf;
-    glGenBuffers(1, &buf);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, gl_usage);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-    return buf;
+    // ceil-divide without forming count + local - 1, which overflows near INT_MAX
+    rcompute_run(c, count_x / local[0] + (count_x % local[0] != 0), count_y / local[1] + (count_y % local[1] != 0),
+                 count_z / local[2] + (count_z % local[2] != 0));
 }
 
 // ---------------------------------
-GLuint rcompute_buffer(GLsizeiptr size, const void *data)
+void rcompute_dispatch_items_1d(rcompute *c, int count_x)
 {
-    return rcompute_buffer_ex(size, data, RCOMPUTE_DYNAMIC);
+    rcompute_dispatch_items_3d(c, count_x, 1, 1);
 }
 
 // ---------------------------------
-GLuint rcompute_buffer_zero(GLsizeiptr size)
+void rcompute_dispatch_items_2d(rcompute *c, int count_x, int count_y)
 {
-    return rcompute_buffer_ex(size, NULL, RCOMPUTE_DYNAMIC);
+    rcompute_dispatch_items_3d(c, count_x, count_y, 1);
 }
 
 // ---------------------------------
-void rcompute_buffer_write(GLuint buf, GLsizeiptr offset, GLsizeiptr size, const void *data)
+void rcompute_run_indirect(rcompute *c, GLuint buf, GLintptr offset)
 {
-    if (buf == 0 || !data || size <= 0)
+    if (!c || c->program == 0)
     {
-        rcompute__err("Invalid buffer write parameters");
+        rcompute__err("Invalid compute context or program");
         return;
     }
 
-    // Bounds checking
-    GLsizeiptr buf_size = rcompute_buffer_size(buf);
-    if (offset + size > buf_size)
+    GLsizeiptr base, size;
+    GLuint gl_buf = rcompute__resolve_buffer(buf, &base, &size);
+    if (!gl_buf || offset < 0 || (offset & 3) || (size > 0 && offset + 3 * (GLintptr)sizeof(GLuint) > size))
     {
-        rcompute__err("Buffer write exceeds buffer bounds");
+        rcompute__err("Invalid indirect buffer or offset");
         return;
     }
 
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
-    glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-    
-    rcompute__debug_log("Buffer write: %lld bytes at offset %lld", (long long)size, (long long)offset);
+    // group counts written by a shader must be visible to the command processor
+    rcompute__buffer_hazard(gl_buf, GL_COMMAND_BARRIER_BIT);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, gl_buf);
+    if (c->last_program != c->program)
+    {
+        glUseProgram(c->program);
+        c->last_program = c->program;
+    }
+    rcompute__dispatch(c->program, 0, 0, 0, base + offset);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
 }
 
 // ---------------------------------
-// Async buffer operations
-// ---------------------------------
-void rcompute_read_async(GLuint buf, void *data, size_t size, size_t offset)
+void rcompute_indirect_args(rcompute *c, GLuint count_buf, GLintptr count_offset, GLuint args_buf,
+                            GLintptr args_offset, GLuint group_size)
 {
-    if (buf == 0)
+    if (!c || group_size == 0)
     {
-        rcompute__err("Invalid buffer handle");
+        rcompute__err("Invalid compute context or group size");
         return;
     }
 
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
-    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
-    
-    // Create or reuse sync object
-    if (rcompute__async_sync)
-        glDeleteSync(rcompute__async_sync);
-    
-    rcompute__async_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-    
-    rcompute__debug_log("Async read initiated: %lld bytes at offset %lld", (long long)size, (long long)offset);
-}
-
-void rcompute_wait_async()
-{
-    if (!rcompute__async_sync)
+    GLsizeiptr count_base, count_size, args_base, args_size;
+    GLuint count_gl = rcompute__resolve_buffer(count_buf, &count_base, &count_size);
+    GLuint args_gl = rcompute__resolve_buffer(args_buf, &args_base, &args_size);
+    if (!count_gl || !args_gl || count_offset < 0 || args_offset < 0 || ((count_offset | args_offset) & 3) ||
+        (count_size > 0 && count_offset + (GLintptr)sizeof(GLuint) > count_size) ||
+        (args_size > 0 && args_offset + 3 * (GLintptr)sizeof(GLuint) > args_size))
     {
-        rcompute__debug_log("No async operation to wait for");
+        rcompute__err("Invalid indirect count or argument buffer");
         return;
     }
 
-    GLenum result = glClientWaitSync(rcompute__async_sync, 0x00000001, 1000000000); // GL_SYNC_FLUSH_BIT, 1 second timeout
-    if (result == GL_TIMEOUT_EXPIRED)
-        rcompute__err("Async operation timeout");
-    else if (result == GL_WAIT_FAILED)
-        rcompute__err("Async wait failed");
-    
-    glDeleteSync(rcompute__async_sync);
-    rcompute__async_sync = NULL;
-    
-    rcompute__debug_log("Async operation completed");
-}
+    if (rcompute__indirect_program == 0)
+    {
+        GLint max_bindings = 8;
+        glGetIntegerv(GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, &max_bindings);
+        rcompute__indirect_binding = max_bindings - 2;
+
+        // offsets are uniforms so the blocks can bind whole buffers regardless of alignment.
+        // Group counts past the x limit spill into y; ceil is taken without forming n + group_size - 1.
+        const GLuint *limit = rcompute__group_limits();
+        char src[1024];
+        snprintf(src, sizeof(src),
+                 "#version 430\n"
+                 "layout(local_size_x = 1) in;\n"
+                 "layout(std430, binding = %d) readonly buffer RcomputeCount { uint rc_count[]; };\n"
+                 "layout(std430, binding = %d) writeonly buffer RcomputeArgs { uint rc_args[]; };\n"
+                 "uniform uint count_index;\n"
+                 "uniform uint args_index;\n"
+                 "uniform uint group_size;\n"
+                 "void main()\n"
+                 "{\n"
+                 "    uint n = rc_count[count_index];\n"
+                 "    uint groups = n / group_size + uint(n %% group_size != 0u);\n"
+                 "    uint x = min(groups, %uu);\n"
+                 "    uint y = x == 0u ? 1u : min(groups / x + uint(groups %% x != 0u), %uu);\n"
+                 "    rc_args[args_index] = x;\n"
+                 "    rc_args[args_index + 1u] = y;\n"
+                 "    rc_args[args_index + 2u] = 1u;\n"
+                 "}\n",
+                 rcompute__indirect_binding, rcompute__indirect_binding + 1, limit[0], limit[1]);
+        rcompute__indirect_program = rcompute_compile(src);
+        if (rcompute__indirect_program == 0)
+            return;
+    }
 
-// ---------------------------------
-void rcompute_buffer_bind(GLuint buf, GLuint binding)
-{
-    if (buf == 0)
+    GLuint program = rcompute__indirect_program;
+    glProgramUniform1ui(program, rcompute__uniform_lookup(program, "count_index"), (GLuint)((count_base + count_offset) / 4));
+    glProgramUniform1ui(program, rcompute__uniform_lookup(program, "args_index"), (GLuint)((args_base + args_offset) / 4));
+    glProgramUniform1ui(program, rcompute__uniform_lookup(program, "group_size"), group_size);
+
+    // The reserved slots may hold the caller's buffers; put them back afterwards
+    GLint saved[2];
+    GLint64 saved_start[2], saved_size[2];
+    for (int i = 0; i < 2; i++)
     {
-        rcompute__err("Invalid buffer handle");
-        return;
+        GLuint binding = rcompute__indirect_binding + i;
+        glGetIntegeri_v(GL_SHADER_STORAGE_BUFFER_BINDING, binding, &saved[i]);
+        glGetInteger64i_v(GL_SHADER_STORAGE_BUFFER_START, binding, &saved_start[i]);
+        glGetInteger64i_v(GL_SHADER_STORAGE_BUFFER_SIZE, binding, &saved_size[i]);
     }
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buf);
+    GLuint saved_program = c->last_program;
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, rcompute__indirect_binding, count_gl);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, rcompute__indirect_binding + 1, args_gl);
+    rcompute__note_binding(0, rcompute__indirect_binding, count_gl, 0);
+    rcompute__note_binding(0, rcompute__indirect_binding + 1, args_gl, 0);
+
+    glUseProgram(program);
+    c->last_program = program;
+    rcompute__dispatch(program, 1, 1, 1, -1);
+
+    for (int i = 0; i < 2; i++)
+    {
+        GLuint binding = rcompute__indirect_binding + i;
+        if (saved[i] != 0 && saved_size[i] > 0)
+            glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, saved[i], (GLintptr)saved_start[i],
+                              (GLsizeiptr)saved_size[i]);
+        else
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, saved[i]);
+        rcompute__note_binding(0, binding, saved[i], saved[i] ? (GLsizeiptr)saved_size[i] : 0);
+    }
+    glUseProgram(saved_program);
+    c->last_program = saved_program;
 }
 
 // ---------------------------------
-void rcompute_buffer_destroy(GLuint buf)
+// Command lists
+// ---------------------------------
+enum
 {
-    if (buf != 0)
-        glDeleteBuffers(1, &buf);
-}
+    RCOMPUTE__CMD_PROGRAM,
+    RCOMPUTE__CMD_BUFFER,
+    RCOMPUTE__CMD_BUFFER_RANGE,
+    RCOMPUTE__CMD_IMAGE,
+    RCOMPUTE__CMD_UNIFORM,
+    RCOMPUTE__CMD_DISPATCH,
+    RCOMPUTE__CMD_BARRIER
+};
+
+enum
+{
+    RCOMPUTE__UNIFORM_INT,
+    RCOMPUTE__UNIFORM_UINT,
+    RCOMPUTE__UNIFORM_FLOAT,
+    RCOMPUTE__UNIFORM_VEC4
+};
 
-// ---------------------------------
-GLsizeiptr rcompute_buffer_size(GLuint buf)
+typedef struct
 {
-    if (buf == 0)
+    int op;
+    GLuint program;     // PROGRAM, UNIFORM
+    GLuint object;      // BUFFER*, IMAGE
+    GLuint binding;     // BUFFER*, IMAGE
+    GLintptr offset;    // BUFFER_RANGE
+    GLsizeiptr size;    // BUFFER_RANGE
+    GLenum format;      // IMAGE
+    GLint location;     // UNIFORM
+    int type;           // UNIFORM
+    int sole;           // UNIFORM: only writer of program+location in the list
+    int dirty;          // UNIFORM: must be sent on the next replay
+    union
     {
-        rcompute__err("Invalid buffer handle");
-        return 0;
-    }
+        GLint i;
+        GLuint u;
+        float f[4];
+    } value;
+    GLuint groups[3];   // DISPATCH (program is the one current when recorded)
+    GLbitfield barriers; // BARRIER
+} rcompute__cmd;
+
+struct rcompute_cmdlist
+{
+    rcompute__cmd *cmds;
+    int count;
+    int cap;
+    GLuint program;     // program at the end of the recording so far
+};
 
-    GLint size = 0;
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
-    glGetBufferParameteriv(GL_SHADER_STORAGE_BUFFER, GL_BUFFER_SIZE, &size);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-    return (GLsizeiptr)size;
+rcompute_cmdlist *rcompute_cmdlist_create(void)
+{
+    rcompute_cmdlist *cl = (rcompute_cmdlist *)calloc(1, sizeof(rcompute_cmdlist));
+    if (!cl)
+        rcompute__err("Failed to allocate command list");
+    return cl;
 }
 
-// ---------------------------------
-// Buffer mapping for large transfers
-// ---------------------------------
-void *rcompute_buffer_map(GLuint buf, GLenum access)
+static rcompute__cmd *rcompute__cmdlist_push(rcompute_cmdlist *cl, int op)
 {
-    if (buf == 0)
+    if (cl->count == cl->cap)
     {
-        rcompute__err("Invalid buffer handle");
-        return NULL;
+        int new_cap = cl->cap ? cl->cap * 2 : 16;
+        rcompute__cmd *cmds = (rcompute__cmd *)realloc(cl->cmds, new_cap * sizeof(rcompute__cmd));
+        if (!cmds)
+        {
+            rcompute__err("Failed to grow command list");
+            return NULL;
+        }
+        cl->cmds = cmds;
+        cl->cap = new_cap;
     }
+    rcompute__cmd *cmd = &cl->cmds[cl->count++];
+    memset(cmd, 0, sizeof(*cmd));
+    cmd->op = op;
+    return cmd;
+}
 
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
-    void *ptr = glMapBuffer(GL_SHADER_STORAGE_BUFFER, access);
-    if (!ptr)
+// most recent bind command for an SSBO binding / image unit, or NULL
+static rcompute__cmd *rcompute__cmdlist_last_bind(rcompute_cmdlist *cl, int image, GLuint binding)
+{
+    for (int i = cl->count - 1; i >= 0; i--)
     {
-        rcompute__err("Failed to map buffer");
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-        return NULL;
+        rcompute__cmd *cmd = &cl->cmds[i];
+        int is_image = cmd->op == RCOMPUTE__CMD_IMAGE;
+        int is_buffer = cmd->op == RCOMPUTE__CMD_BUFFER || cmd->op == RCOMPUTE__CMD_BUFFER_RANGE;
+        if ((image ? is_image : is_buffer) && cmd->binding == binding)
+            return cmd;
     }
-    
-    rcompute__debug_log("Buffer mapped");
-    return ptr;
+    return NULL;
 }
 
-void rcompute_buffer_unmap(GLuint buf)
+void rcompute_cmdlist_program(rcompute_cmdlist *cl, GLuint program)
 {
-    if (buf == 0)
+    if (!cl || program == 0)
     {
-        rcompute__err("Invalid buffer handle");
+        rcompute__err("Invalid command list program");
         return;
     }
+    if (cl->program == program)
+        return;
 
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
-    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-    
-    rcompute__debug_log("Buffer unmapped");
+    rcompute__cmd *cmd = rcompute__cmdlist_push(cl, RCOMPUTE__CMD_PROGRAM);
+    if (cmd)
+        cmd->program = program;
+    cl->program = program;
 }
 
-// ---------------------------------
-// Texture operations
-// ---------------------------------
-GLuint rcompute_texture_2d(int width, int height, GLenum format, const void *data)
+void rcompute_cmdlist_buffer(rcompute_cmdlist *cl, GLuint buf, GLuint binding)
 {
-    if (width <= 0 || height <= 0)
+    if (!cl || buf == 0)
     {
-        rcompute__err("Invalid texture dimensions");
-        return 0;
+        rcompute__err("Invalid command list buffer");
+        return;
     }
 
-    GLuint tex;
-    glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
+    GLsizeiptr base, size;
+    GLuint gl_buf = rcompute__resolve_buffer(buf, &base, &size);
+    int op = (buf & RCOMPUTE_SLICE_BIT) ? RCOMPUTE__CMD_BUFFER_RANGE : RCOMPUTE__CMD_BUFFER;
+    if (!gl_buf)
+    {
+        rcompute__err("Invalid slice handle");
+        return;
+    }
 
-    // Set texture parameters
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    rcompute__cmd *last = rcompute__cmdlist_last_bind(cl, 0, binding);
+    if (last && last->op == op && last->object == gl_buf && last->offset == base && last->size == size)
+        return;
 
-    // Determine internal format and type
-    GLenum internal_format = format;
-    GLenum type = GL_UNSIGNED_BYTE;
-    GLenum base_format = format;
+    rcompute__cmd *cmd = rcompute__cmdlist_push(cl, op);
+    if (!cmd)
+        return;
+    cmd->object = gl_buf;
+    cmd->binding = binding;
+    cmd->offset = op == RCOMPUTE__CMD_BUFFER_RANGE ? base : 0;
+    cmd->size = op == RCOMPUTE__CMD_BUFFER_RANGE ? size : 0;
+}
 
-    if (format == GL_R32F || format == GL_RG32F || format == GL_RGBA32F)
-    {
-        type = GL_FLOAT;
-        if (format == GL_R32F) base_format = GL_RED;
-        else if (format == GL_RG32F) base_format = GL_RG;
-        else base_format = GL_RGBA;
-    }
-    else if (format == GL_R32I || format == GL_RG32I || format == GL_RGBA32I)
-    {
-        type = GL_INT;
-        if (format == GL_R32I) base_format = GL_RED_INTEGER;
-        else if (format == GL_RG32I) base_format = GL_RG_INTEGER;
-        else base_format = GL_RGBA_INTEGER;
-    }
-    else if (format == GL_R32UI || format == GL_RG32UI || format == GL_RGBA32UI)
+void rcompute_cmdlist_texture(rcompute_cmdlist *cl, GLuint tex, GLuint unit, GLenum format)
+{
+    if (!cl || tex == 0)
     {
-        type = GL_UNSIGNED_INT;
-        if (format == GL_R32UI) base_format = GL_RED_INTEGER;
-        else if (format == GL_RG32UI) base_format = GL_RG_INTEGER;
-        else base_format = GL_RGBA_INTEGER;
+        rcompute__err("Invalid command list texture");
+        return;
     }
 
-    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, base_format, type, data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    rcompute__cmd *last = rcompute__cmdlist_last_bind(cl, 1, unit);
+    if (last && last->object == tex && last->format == format)
+        return;
 
-    rcompute__debug_log("2D texture created: %dx%d format=%d", width, height, format);
-    return tex;
+    rcompute__cmd *cmd = rcompute__cmdlist_push(cl, RCOMPUTE__CMD_IMAGE);
+    if (!cmd)
+        return;
+    cmd->object = tex;
+    cmd->binding = unit;
+    cmd->format = format;
 }
 
-GLuint rcompute_texture_3d(int width, int height, int depth, GLenum format, const void *data)
+static rcompute__cmd *rcompute__cmdlist_uniform(rcompute_cmdlist *cl, const char *name, int type, int *param)
 {
-    if (width <= 0 || height <= 0 || depth <= 0)
+    *param = -1;
+    if (!cl || !name || cl->program == 0)
     {
-        rcompute__err("Invalid texture dimensions");
-        return 0;
+        rcompute__err("Command list uniform recorded without a program");
+        return NULL;
     }
 
-    GLuint tex;
-    glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_3D, tex);
+    GLint loc = rcompute__uniform_lookup(cl->program, name);
+    if (loc < 0)
+    {
+        rcompute__debug_log("Command list uniform '%s' not found", name);
+        return NULL;
+    }
 
-    // Set texture parameters
-    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    // Another writer of the same location means the value must be re-sent on every replay
+    int sole = 1;
+    for (int i = 0; i < cl->count; i++)
+    {
+        rcompute__cmd *other = &cl->cmds[i];
+        if (other->op == RCOMPUTE__CMD_UNIFORM && other->program == cl->program && other->location == loc)
+        {
+            other->sole = 0;
+            sole = 0;
+        }
+    }
 
-    // Determine internal format and type
-    GLenum internal_format = format;
-    GLenum type = GL_UNSIGNED_BYTE;
-    GLenum base_format = format;
+    rcompute__cmd *cmd = rcompute__cmdlist_push(cl, RCOMPUTE__CMD_UNIFORM);
+    if (!cmd)
+        return NULL;
+    cmd->program = cl->program;
+    cmd->location = loc;
+    cmd->type = type;
+    cmd->sole = sole;
+    cmd->dirty = 1;
+    *param = cl->count - 1;
+    return cmd;
+}
 
-    if (format == GL_R32F || format == GL_RG32F || format == GL_RGBA32F)
+int rcompute_cmdlist_uniform_int(rcompute_cmdlist *cl, const char *name, int value)
+{
+    int param;
+    rcompute__cmd *cmd = rcompute__cmdlist_uniform(cl, name, RCOMPUTE__UNIFORM_INT, &param);
+    if (cmd)
+        cmd->value.i = value;
+    return param;
+}
+
+int rcompute_cmdlist_uniform_uint(rcompute_cmdlist *cl, const char *name, unsigned int value)
+{
+    int param;
+    rcompute__cmd *cmd = rcompute__cmdlist_uniform(cl, name, RCOMPUTE__UNIFORM_UINT, &param);
+    if (cmd)
+        cmd->value.u = value;
+    return param;
+}
+
+int rcompute_cmdlist_uniform_float(rcompute_cmdlist *cl, const char *name, float value)
+{
+    int param;
+    rcompute__cmd *cmd = rcompute__cmdlist_uniform(cl, name, RCOMPUTE__UNIFORM_FLOAT, &param);
+    if (cmd)
+        cmd->value.f[0] = value;
+    return param;
+}
+
+int rcompute_cmdlist_uniform_vec4(rcompute_cmdlist *cl, const char *name, float x, float y, float z, float w)
+{
+    int param;
+    rcompute__cmd *cmd = rcompute__cmdlist_uniform(cl, name, RCOMPUTE__UNIFORM_VEC4, &param);
+    if (cmd)
     {
-        type = GL_FLOAT;
-        if (format == GL_R32F) base_format = GL_RED;
-        else if (format == GL_RG32F) base_format = GL_RG;
-        else base_format = GL_RGBA;
+        cmd->value.f[0] = x;
+        cmd->value.f[1] = y;
+        cmd->value.f[2] = z;
+        cmd->value.f[3] = w;
     }
-    else if (format == GL_R32I || format == GL_RG32I || format == GL_RGBA32I)
+    return param;
+}
+
+void rcompute_cmdlist_dispatch(rcompute_cmdlist *cl, int nx, int ny, int nz)
+{
+    if (!cl || cl->program == 0)
     {
-        type = GL_INT;
-        if (format == GL_R32I) base_format = GL_RED_INTEGER;
-        else if (format == GL_RG32I) base_format = GL_RG_INTEGER;
-        else base_format = GL_RGBA_INTEGER;
+        rcompute__err("Command list dispatch recorded without a program");
+        return;
     }
-    else if (format == GL_R32UI || format == GL_RG32UI || format == GL_RGBA32UI)
+
+    rcompute__cmd *cmd = rcompute__cmdlist_push(cl, RCOMPUTE__CMD_DISPATCH);
+    if (!cmd)
+        return;
+    cmd->program = cl->program;
+    cmd->groups[0] = nx;
+    cmd->groups[1] = ny;
+    cmd->groups[2] = nz;
+}
+
+void rcompute_cmdlist_barrier(rcompute_cmdlist *cl, GLbitfield barriers)
+{
+    if (!cl || barriers == 0)
+        return;
+
+    // Adjacent barriers merge into one glMemoryBarrier
+    if (cl->count > 0 && cl->cmds[cl->count - 1].op == RCOMPUTE__CMD_BARRIER)
     {
-        type = GL_UNSIGNED_INT;
-        if (format == GL_R32UI) base_format = GL_RED_INTEGER;
-        else if (format == GL_RG32UI) base_format = GL_RG_INTEGER;
-        else base_format = GL_RGBA_INTEGER;
+        cl->cmds[cl->count - 1].barriers |= barriers;
+        return;
     }
 
-    glTexImage3D(GL_TEXTURE_3D, 0, internal_format, width, height, depth, 0, base_format, type, data);
-    glBindTexture(GL_TEXTURE_3D, 0);
-
-    rcompute__debug_log("3D texture created: %dx%dx%d format=%d", width, height, depth, format);
-    return tex;
+    rcompute__cmd *cmd = rcompute__cmdlist_push(cl, RCOMPUTE__CMD_BARRIER);
+    if (cmd)
+        cmd->barriers = barriers;
 }
 
-void rcompute_texture_bind(GLuint tex, GLuint unit, GLenum format)
+static rcompute__cmd *rcompute__cmdlist_param(rcompute_cmdlist *cl, int param, int type)
 {
-    if (tex == 0)
+    if (!cl || param < 0 || param >= cl->count || cl->cmds[param].op != RCOMPUTE__CMD_UNIFORM ||
+        cl->cmds[param].type != type)
     {
-        rcompute__err("Invalid texture handle");
-        return;
+        rcompute__err("Invalid command list parameter");
+        return NULL;
     }
-    glBindImageTexture(unit, tex, 0, GL_FALSE, 0, GL_READ_WRITE, format);
-    rcompute__debug_log("Texture bound to unit %u with format %d", unit, format);
+    cl->cmds[param].dirty = 1;
+    return &cl->cmds[param];
 }
 
-void rcompute_texture_destroy(GLuint tex)
+void rcompute_cmdlist_set_int(rcompute_cmdlist *cl, int param, int value)
 {
-    if (tex != 0)
-        glDeleteTextures(1, &tex);
+    rcompute__cmd *cmd = rcompute__cmdlist_param(cl, param, RCOMPUTE__UNIFORM_INT);
+    if (cmd)
+        cmd->value.i = value;
 }
 
-// ---------------------------------
-void rcompute_run(rcompute *c, int nx, int ny, int nz)
+void rcompute_cmdlist_set_uint(rcompute_cmdlist *cl, int param, unsigned int value)
 {
-    if (!c || c->program == 0)
+    rcompute__cmd *cmd = rcompute__cmdlist_param(cl, param, RCOMPUTE__UNIFORM_UINT);
+    if (cmd)
+        cmd->value.u = value;
+}
+
+void rcompute_cmdlist_set_float(rcompute_cmdlist *cl, int param, float value)
+{
+    rcompute__cmd *cmd = rcompute__cmdlist_param(cl, param, RCOMPUTE__UNIFORM_FLOAT);
+    if (cmd)
+        cmd->value.f[0] = value;
+}
+
+void rcompute_cmdlist_set_vec4(rcompute_cmdlist *cl, int param, float x, float y, float z, float w)
+{
+    rcompute__cmd *cmd = rcompute__cmdlist_param(cl, param, RCOMPUTE__UNIFORM_VEC4);
+    if (cmd)
     {
-        rcompute__err("Invalid compute context or program");
-        return;
+        cmd->value.f[0] = x;
+        cmd->value.f[1] = y;
+        cmd->value.f[2] = z;
+        cmd->value.f[3] = w;
     }
+}
 
-    glUseProgram(c->program);
-    glDispatchCompute(nx, ny, nz);
-    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+void rcompute_cmdlist_invalidate(rcompute_cmdlist *cl)
+{
+    if (!cl)
+        return;
+    for (int i = 0; i < cl->count; i++)
+        cl->cmds[i].dirty = 1;
 }
 
-// ---------------------------------
-void rcompute_dispatch_1d(rcompute *c, int nx)
+void rcompute_cmdlist_replay(rcompute *c, rcompute_cmdlist *cl, int times)
 {
-    rcompute_run(c, nx, 1, 1);
+    if (!c || !cl)
+    {
+        rcompute__err("Invalid command list replay");
+        return;
+    }
+
+    for (int t = 0; t < times; t++)
+    {
+        for (int i = 0; i < cl->count; i++)
+        {
+            rcompute__cmd *cmd = &cl->cmds[i];
+            switch (cmd->op)
+            {
+            case RCOMPUTE__CMD_PROGRAM:
+                if (c->last_program != cmd->program)
+                {
+                    glUseProgram(cmd->program);
+                    c->last_program = cmd->program;
+                }
+                break;
+            case RCOMPUTE__CMD_BUFFER:
+                glBindBufferBase(GL_SHADER_STORAGE_BUFFER, cmd->binding, cmd->object);
+                rcompute__note_binding(0, cmd->binding, cmd->object, 0);
+                break;
+            case RCOMPUTE__CMD_BUFFER_RANGE:
+                glBindBufferRange(GL_SHADER_STORAGE_BUFFER, cmd->binding, cmd->object, cmd->offset, cmd->size);
+                rcompute__note_binding(0, cmd->binding, cmd->object, cmd->size);
+                break;
+            case RCOMPUTE__CMD_IMAGE:
+                glBindImageTexture(cmd->binding, cmd->object, 0, GL_FALSE, 0, GL_READ_WRITE, cmd->format);
+                rcompute__note_binding(1, cmd->binding, cmd->object, 0);
+                break;
+            case RCOMPUTE__CMD_UNIFORM:
+                // Uniform values live in the program object, so a sole writer only needs sending once
+                if (cmd->sole && !cmd->dirty)
+                    break;
+                switch (cmd->type)
+                {
+                case RCOMPUTE__UNIFORM_INT:
+                    glProgramUniform1i(cmd->program, cmd->location, cmd->value.i);
+                    break;
+                case RCOMPUTE__UNIFORM_UINT:
+                    glProgramUniform1ui(cmd->program, cmd->location, cmd->value.u);
+                    break;
+                case RCOMPUTE__UNIFORM_FLOAT:
+                    glProgramUniform1f(cmd->program, cmd->location, cmd->value.f[0]);
+                    break;
+                default:
+                    glProgramUniform4fv(cmd->program, cmd->location, 1, cmd->value.f);
+                    break;
+                }
+                cmd->dirty = 0;
+                break;
+            case RCOMPUTE__CMD_DISPATCH:
+                rcompute__dispatch(cmd->program, cmd->groups[0], cmd->groups[1], cmd->groups[2], -1);
+                break;
+            case RCOMPUTE__CMD_BARRIER:
+                rcompute__barrier_issue(cmd->barriers);
+                break;
+            }
+        }
+    }
 }
 
-// ---------------------------------
-void rcompute_dispatch_2d(rcompute *c, int nx, int ny)
+void rcompute_cmdlist_destroy(rcompute_cmdlist *cl)
 {
-    rcompute_run(c, nx, ny, 1);
+    if (!cl)
+        return;
+    free(cl->cmds);
+    free(cl);
 }
 
 // ---------------------------------
@@ -883,17 +5610,29 @@ void rcompute_read(GLuint buf, void *out, GLsizeiptr size)
         return;
     }
 
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
-    void *ptr = glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
+    GLsizeiptr base, known_size;
+    GLuint gl_buf = rcompute__resolve_buffer(buf, &base, &known_size);
+    if (!gl_buf || (known_size && size > known_size))
+    {
+        rcompute__err("Buffer read exceeds buffer bounds");
+        return;
+    }
+
+    rcompute__buffer_hazard(gl_buf, GL_BUFFER_UPDATE_BARRIER_BIT);
+    int ev = rcompute__prof_begin("readback", "buffer read", size);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, gl_buf);
+    void *ptr = glMapBufferRange(GL_SHADER_STORAGE_BUFFER, base, size, GL_MAP_READ_BIT);
     if (!ptr)
     {
         rcompute__err("Failed to map buffer");
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        rcompute__prof_end(ev);
         return;
     }
     memcpy(out, ptr, size);
     glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    rcompute__prof_end(ev);
 }
 
 // ---------------------------------
@@ -902,14 +5641,97 @@ void rcompute_destroy(rcompute *c)
     if (!c)
         return;
 
-    if (c->program != 0)
-        glDeleteProgram(c->program);
+    if (c->program != 0 && !rcompute__variant_by_program(c->program))
+        rcompute__delete_program(c->program);
+    if (rcompute__indirect_program != 0)
+        rcompute__delete_program(rcompute__indirect_program);
+    rcompute__indirect_program = 0;
+    rcompute__indirect_binding = 0;
+
+    // Cached variants and registry entries name programs of this context; a later context may
+    // hand out the same names for different programs
+    rcompute_evict_variants(1);
+    while (rcompute__program_count > 0)
+        rcompute__program_forget(rcompute__programs[0].program);
+    free(rcompute__programs);
+    rcompute__programs = NULL;
+    rcompute__program_cap = 0;
+    free(rcompute__pending);
+    rcompute__pending = NULL;
+    rcompute__pending_count = rcompute__pending_cap = 0;
+
+    // Binding tables, hazard serials and capabilities are re-learned by the next context
+    memset(rcompute__ssbo_bound, 0, sizeof(rcompute__ssbo_bound));
+    memset(rcompute__image_bound, 0, sizeof(rcompute__image_bound));
+    memset(rcompute__ssbo_bound_bytes, 0, sizeof(rcompute__ssbo_bound_bytes));
+    memset(rcompute__barrier_serial, 0, sizeof(rcompute__barrier_serial));
+    rcompute__serial = rcompute__last_write = rcompute__unknown_write = 0;
+    memset(rcompute__group_limit, 0, sizeof(rcompute__group_limit));
+    rcompute__parallel_compile = -1;
+
+    if (c->param_ubo != 0)
+    {
+        rcompute__untrack(c->param_ubo, RCOMPUTE__OBJ_BUFFER);
+        glDeleteBuffers(1, &c->param_ubo);
+    }
+    c->param_ubo = 0;
 
+    // Staging buffers belong to this context's GL objects
+    for (int i = 0; i < rcompute__readback_count; i++)
+    {
+        if (rcompute__readbacks[i].fence)
+            glDeleteSync(rcompute__readbacks[i].fence);
+        rcompute__readback_free_staging(&rcompute__readbacks[i]);
+    }
+    free(rcompute__readbacks);
+    rcompute__readbacks = NULL;
+    rcompute__readback_count = 0;
+    rcompute__buffer_storage = -1;
+
+    // Timer queries and their statistics, then profiler events (their queries die with the context)
+    rcompute_timer_destroy();
+    rcompute_profiler_reset();
+    rcompute__prof_enabled = 0;
+    for (int i = 0; i < rcompute__sample_count; i++)
+        glDeleteQueries(2, rcompute__samples[i].query);
+    free(rcompute__samples);
+    rcompute__samples = NULL;
+    rcompute__sample_count = rcompute__sample_cap = 0;
+
+    // Whatever is still registered dies with the context: report it as leaked
+    if (rcompute__debug)
+    {
+        if (rcompute__object_count > 0)
+            rcompute__memory_print(stdout, "[rcompute] leaked: ");
+        else
+            rcompute__debug_log("GPU memory: peak %lld bytes, no leaks", rcompute__peak_bytes);
+    }
+    free(rcompute__objects);
+    rcompute__objects = NULL;
+    rcompute__object_count = 0;
+    rcompute__object_cap = 0;
+    rcompute__live_bytes = 0;
+    rcompute__peak_bytes = 0;
+
+#ifndef RCOMPUTE_NO_GLFW
     if (c->window)
         glfwDestroyWindow(c->window);
+    c->window = NULL;
+#endif
+
+#ifdef RCOMPUTE_USE_EGL
+    if (c->egl_context)
+    {
+        EGLDisplay dpy = (EGLDisplay)c->egl_display;
+        eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(dpy, (EGLContext)c->egl_context);
+        c->egl_context = NULL;
+        c->egl_display = NULL;
+    }
+#endif
 
-    // Don't terminate GLFW here - allow multiple contexts
-    // User should call glfwTerminate() manually if needed
+    // Don't terminate GLFW/EGL display here - allow multiple contexts
+    // User should call glfwTerminate() / eglTerminate() manually if needed
 }
 
 // ---------------------------------
@@ -923,12 +5745,12 @@ const char *rcompute_get_last_error(void)
 // ---------------------------------
 void rcompute_barrier(GLenum barriers)
 {
-    glMemoryBarrier(barriers);
+    rcompute__barrier_issue(barriers);
 }
 
 void rcompute_barrier_all(void)
 {
-    glMemoryBarrier(GL_ALL_BARRIER_BITS);
+    rcompute__barrier_issue(GL_ALL_BARRIER_BITS);
 }
 
 // ---------------------------------
@@ -963,6 +5785,345 @@ double rcompute_timer_end(void)
     return (double)elapsed_ns / 1000000.0;
 }
 
+static int rcompute__timer_stat_find(const char *label, int create)
+{
+    for (int i = 0; i < rcompute__timer_stat_count; i++)
+        if (strncmp(rcompute__timer_stats[i].label, label, sizeof(rcompute__timer_stats[i].label) - 1) == 0)
+            return i;
+    if (!create)
+        return -1;
+
+    if (rcompute__timer_stat_count == rcompute__timer_stat_cap)
+    {
+        int new_cap = rcompute__timer_stat_cap ? rcompute__timer_stat_cap * 2 : 16;
+        rcompute__timer_stat *p = (rcompute__timer_stat *)realloc(rcompute__timer_stats,
+                                                                  new_cap * sizeof(rcompute__timer_stat));
+        if (!p)
+            return -1;
+        rcompute__timer_stats = p;
+        rcompute__timer_stat_cap = new_cap;
+    }
+    rcompute__timer_stat *st = &rcompute__timer_stats[rcompute__timer_stat_count];
+    memset(st, 0, sizeof(*st));
+    snprintf(st->label, sizeof(st->label), "%s", label);
+    return rcompute__timer_stat_count++;
+}
+
+// ---------------------------------
+void rcompute_timer_push(const char *label)
+{
+    if (rcompute__timer_depth == RCOMPUTE__TIMER_DEPTH)
+    {
+        rcompute__err("Timer scopes nested too deeply");
+        return;
+    }
+
+    rcompute__timer_scope *scope = &rcompute__timer_stack[rcompute__timer_depth];
+    scope->stat = rcompute__timer_stat_find(label ? label : "(unnamed)", 1);
+    if (scope->stat < 0)
+    {
+        rcompute__err("Out of memory for timer statistics");
+        return;
+    }
+    rcompute__timer_stats[scope->stat].depth = rcompute__timer_depth;
+    scope->begin = rcompute__timer_query();
+    scope->end = 0;
+    glQueryCounter(scope->begin, GL_TIMESTAMP);
+    rcompute__timer_depth++;
+}
+
+// ---------------------------------
+void rcompute_timer_pop(void)
+{
+    if (rcompute__timer_depth == 0)
+    {
+        rcompute__err("Timer pop without push");
+        return;
+    }
+
+    rcompute__timer_scope scope = rcompute__timer_stack[--rcompute__timer_depth];
+    scope.end = rcompute__timer_query();
+    glQueryCounter(scope.end, GL_TIMESTAMP);
+
+    if (rcompute__timer_pending_count == rcompute__timer_pending_cap)
+    {
+        int new_cap = rcompute__timer_pending_cap ? rcompute__timer_pending_cap * 2 : 64;
+        rcompute__timer_scope *p = (rcompute__timer_scope *)realloc(rcompute__timer_pending,
+                                                                    new_cap * sizeof(rcompute__timer_scope));
+        if (!p)
+        {
+            rcompute__timer_release(scope.begin);
+            rcompute__timer_release(scope.end);
+            return;
+        }
+        rcompute__timer_pending = p;
+        rcompute__timer_pending_cap = new_cap;
+    }
+    rcompute__timer_pending[rcompute__timer_pending_count++] = scope;
+
+    // opportunistic: keeps the queue short without the caller polling
+    rcompute_timer_collect(0);
+}
+
+// ---------------------------------
+int rcompute_timer_collect(int wait)
+{
+    // scopes are queued in the order they ended, which is the order the GPU finishes them
+    int done = 0;
+    while (done < rcompute__timer_pending_count)
+    {
+        rcompute__timer_scope *scope = &rcompute__timer_pending[done];
+        if (!wait)
+        {
+            GLint available = 0;
+            glGetQueryObjectiv(scope->end, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+        }
+
+        GLuint64 t0 = 0, t1 = 0;
+        glGetQueryObjectui64v(scope->begin, GL_QUERY_RESULT, &t0);
+        glGetQueryObjectui64v(scope->end, GL_QUERY_RESULT, &t1);
+        rcompute__timer_release(scope->begin);
+        rcompute__timer_release(scope->end);
+
+        rcompute__timer_stat *st = &rcompute__timer_stats[scope->stat];
+        double ms = t1 > t0 ? (double)(t1 - t0) / 1000000.0 : 0.0;
+        st->window[st->count % RCOMPUTE_TIMER_WINDOW] = ms;
+        st->count++;
+        st->last_ms = ms;
+        st->total_ms += ms;
+        done++;
+    }
+
+    if (done > 0)
+    {
+        memmove(rcompute__timer_pending, rcompute__timer_pending + done,
+                (rcompute__timer_pending_count - done) * sizeof(rcompute__timer_scope));
+        rcompute__timer_pending_count -= done;
+    }
+    return done;
+}
+
+// ---------------------------------
+int rcompute_timer_stats_get(const char *label, rcompute_timer_stats *out)
+{
+    int index = label ? rcompute__timer_stat_find(label, 0) : -1;
+    if (index < 0 || !out || rcompute__timer_stats[index].count == 0)
+        return 0;
+
+    const rcompute__timer_stat *st = &rcompute__timer_stats[index];
+    int n = st->count < RCOMPUTE_TIMER_WINDOW ? (int)st->count : RCOMPUTE_TIMER_WINDOW;
+    snprintf(out->label, sizeof(out->label), "%s", st->label);
+    out->depth = st->depth;
+    out->count = st->count;
+    out->last_ms = st->last_ms;
+    out->total_ms = st->total_ms;
+    out->min_ms = out->max_ms = st->window[0];
+    double sum = 0.0;
+    for (int i = 0; i < n; i++)
+    {
+        sum += st->window[i];
+        if (st->window[i] < out->min_ms)
+            out->min_ms = st->window[i];
+        if (st->window[i] > out->max_ms)
+            out->max_ms = st->window[i];
+    }
+    out->avg_ms = sum / n;
+    return 1;
+}
+
+// ---------------------------------
+void rcompute_timer_report(void)
+{
+    printf("[rcompute] GPU timers (last %d samples):\n", RCOMPUTE_TIMER_WINDOW);
+    for (int i = 0; i < rcompute__timer_stat_count; i++)
+    {
+        rcompute_timer_stats st;
+        if (!rcompute_timer_stats_get(rcompute__timer_stats[i].label, &st))
+            continue;
+        printf("[rcompute]   %*s%-*s avg %8.3f ms  min %8.3f  max %8.3f  total %10.2f ms  (%lld)\n",
+               st.depth * 2, "", 32 - st.depth * 2, st.label, st.avg_ms, st.min_ms, st.max_ms, st.total_ms,
+               st.count);
+    }
+}
+
+// ---------------------------------
+void rcompute_timer_destroy(void)
+{
+    if (rcompute__query_id != 0)
+        glDeleteQueries(1, &rcompute__query_id);
+    rcompute__query_id = 0;
+    rcompute__query_available = 0;
+
+    for (int i = 0; i < rcompute__timer_pending_count; i++)
+    {
+        glDeleteQueries(1, &rcompute__timer_pending[i].begin);
+        glDeleteQueries(1, &rcompute__timer_pending[i].end);
+    }
+    for (int i = 0; i < rcompute__timer_depth; i++)
+        glDeleteQueries(1, &rcompute__timer_stack[i].begin);
+    if (rcompute__timer_free_count > 0)
+        glDeleteQueries(rcompute__timer_free_count, rcompute__timer_free);
+
+    free(rcompute__timer_free);
+    free(rcompute__timer_pending);
+    free(rcompute__timer_stats);
+    rcompute__timer_free = NULL;
+    rcompute__timer_pending = NULL;
+    rcompute__timer_stats = NULL;
+    rcompute__timer_free_count = rcompute__timer_free_cap = 0;
+    rcompute__timer_pending_count = rcompute__timer_pending_cap = 0;
+    rcompute__timer_stat_count = rcompute__timer_stat_cap = 0;
+    rcompute__timer_depth = 0;
+}
+
+// ---------------------------------
+// Profiler
+// ---------------------------------
+void rcompute_profiler_enable(int enable)
+{
+    if (enable && !rcompute__prof_enabled && rcompute__prof_count == 0)
+    {
+        // trace time 0; GPU timestamps are placed relative to the same moment
+        glGetInteger64v(GL_TIMESTAMP, &rcompute__prof_gpu_base);
+        rcompute__prof_cpu_base = rcompute__now_ns();
+    }
+    rcompute__prof_enabled = enable;
+    rcompute__debug_log("Profiler %s", enable ? "enabled" : "disabled");
+}
+
+// ---------------------------------
+int rcompute_profiler_write_trace(const char *path)
+{
+    FILE *f = path ? fopen(path, "w") : NULL;
+    if (!f)
+    {
+        rcompute__err_ex("Failed to open trace file: %s", path ? path : "(null)");
+        return 0;
+    }
+    rcompute__prof_resolve(1);
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"rcompute\"}},\n");
+    fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU submit\"}},\n");
+    fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+    for (int i = 0; i < rcompute__prof_resolved; i++)
+    {
+        const rcompute__prof_event *ev = &rcompute__prof_events[i];
+        double ts[2] = {(ev->cpu[0] - rcompute__prof_cpu_base) / 1000.0,
+                        ((GLint64)ev->gpu[0] - rcompute__prof_gpu_base) / 1000.0};
+        double dur[2] = {(ev->cpu[1] - ev->cpu[0]) / 1000.0,
+                         ev->gpu[1] > ev->gpu[0] ? (ev->gpu[1] - ev->gpu[0]) / 1000.0 : 0.0};
+        for (int track = 0; track < 2; track++)
+        {
+            fprintf(f, ",\n{\"name\":");
+            rcompute__json_string(f, ev->name);
+            fprintf(f, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{",
+                    ev->cat, track + 1, ts[track], dur[track]);
+            if (strcmp(ev->cat, "dispatch") == 0)
+                fprintf(f, "\"groups\":[%u,%u,%u],\"indirect\":%d,\"bytes_read\":%lld,\"bytes_written\":%lld",
+                        ev->groups[0], ev->groups[1], ev->groups[2], ev->indirect, ev->bytes, ev->bytes_written);
+            else if (strcmp(ev->cat, "barrier") == 0)
+                fprintf(f, "\"bits\":\"0x%x\"", ev->barriers);
+            else
+                fprintf(f, "\"bytes\":%lld", ev->bytes);
+            fprintf(f, "}}");
+        }
+    }
+    fprintf(f, "\n]}\n");
+
+    int ok = !ferror(f);
+    fclose(f);
+    if (!ok)
+        rcompute__err_ex("Failed to write trace file: %s", path);
+    else
+        rcompute__debug_log("Profiler trace: %d events written to %s", rcompute__prof_resolved, path);
+    if (rcompute__prof_dropped > 0)
+        rcompute__debug_log("Profiler trace: %lld events dropped at the event limit", rcompute__prof_dropped);
+    return ok;
+}
+
+// ---------------------------------
+void rcompute_profiler_reset(void)
+{
+    for (int i = rcompute__prof_resolved; i < rcompute__prof_count; i++)
+        for (int q = 0; q < 2; q++)
+            if (rcompute__prof_events[i].query[q])
+                glDeleteQueries(1, &rcompute__prof_events[i].query[q]);
+    free(rcompute__prof_events);
+    rcompute__prof_events = NULL;
+    rcompute__prof_count = rcompute__prof_cap = rcompute__prof_resolved = 0;
+    rcompute__prof_dropped = 0;
+    if (rcompute__prof_enabled)
+    {
+        glGetInteger64v(GL_TIMESTAMP, &rcompute__prof_gpu_base);
+        rcompute__prof_cpu_base = rcompute__now_ns();
+    }
+}
+
+// ---------------------------------
+// Throughput accounting
+// ---------------------------------
+void rcompute_dispatch_stats_enable(int enable)
+{
+    rcompute__stats_enabled = enable;
+}
+
+// ---------------------------------
+int rcompute_dispatch_stats_get(GLuint program, rcompute_dispatch_stats *out)
+{
+    rcompute__stats_resolve(1);
+    int index = rcompute__program_find(program);
+    if (index < 0 || !out || rcompute__programs[index].stat_dispatches == 0)
+        return 0;
+
+    const rcompute__program_info *info = &rcompute__programs[index];
+    double seconds = info->stat_gpu_ms / 1000.0;
+    snprintf(out->label, sizeof(out->label), "%s", info->label);
+    out->dispatches = info->stat_dispatches;
+    out->invocations = info->stat_invocations;
+    out->bytes_read = info->stat_bytes_read;
+    out->bytes_written = info->stat_bytes_written;
+    out->gpu_ms = info->stat_gpu_ms;
+    out->gb_per_s = seconds > 0.0 ? (info->stat_bytes_read + info->stat_bytes_written) / seconds / 1e9 : 0.0;
+    out->invocations_per_s = seconds > 0.0 ? info->stat_invocations / seconds : 0.0;
+    return 1;
+}
+
+// ---------------------------------
+void rcompute_dispatch_stats_report(void)
+{
+    rcompute__stats_resolve(1);
+    printf("[rcompute] Dispatch throughput:\n");
+    for (int i = 0; i < rcompute__program_count; i++)
+    {
+        rcompute_dispatch_stats st;
+        GLuint program = rcompute__programs[i].program;
+        if (!rcompute_dispatch_stats_get(program, &st))
+            continue;
+        char name[48];
+        snprintf(name, sizeof(name), "%s", st.label);
+        if (!name[0])
+            snprintf(name, sizeof(name), "program %u", program);
+        printf("[rcompute]   %-32s %6lld dispatches  %10.2f ms  %8.2f GB/s  %10.1f M invocations/s\n", name,
+               st.dispatches, st.gpu_ms, st.gb_per_s, st.invocations_per_s / 1e6);
+    }
+}
+
+// ---------------------------------
+void rcompute_dispatch_stats_reset(void)
+{
+    rcompute__stats_resolve(1);
+    for (int i = 0; i < rcompute__program_count; i++)
+    {
+        rcompute__program_info *info = &rcompute__programs[i];
+        info->stat_dispatches = info->stat_invocations = 0;
+        info->stat_bytes_read = info->stat_bytes_written = 0;
+        info->stat_gpu_ms = 0.0;
+    }
+}
+
 // ---------------------------------
 // Query compute limits
 // ---------------------------------
@@ -996,4 +6157,14 @@ void rcompute_get_limits(rcompute *c, int *max_work_group_count_x,
 }
 
 #endif // RCOMPUTE_IMPLEMENTATION
+
+// Record creation sites (after the implementation so library-internal calls are untouched)
+#ifdef RCOMPUTE_TRACK_ALLOCATIONS
+#define rcompute_buffer(size, data) rcompute_buffer_tracked(size, data, RCOMPUTE_DYNAMIC, __FILE__, __LINE__)
+#define rcompute_buffer_ex(size, data, usage) rcompute_buffer_tracked(size, data, usage, __FILE__, __LINE__)
+#define rcompute_buffer_zero(size) rcompute_buffer_zero_tracked(size, __FILE__, __LINE__)
+#define rcompute_texture_2d(w, h, format, data) rcompute_texture_2d_tracked(w, h, format, data, __FILE__, __LINE__)
+#define rcompute_texture_3d(w, h, d, format, data) rcompute_texture_3d_tracked(w, h, d, format, data, __FILE__, __LINE__)
+#endif
+
 #endif // RCOMPUTE_H
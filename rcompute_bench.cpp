@@ -0,0 +1,326 @@
+// rcompute_bench - transfer and dispatch microbenchmarks
+// Measures upload/readback bandwidth per path, dispatch latency, barrier cost, compile time and
+// peak SSBO bandwidth. Runs through the shared example harness (example_bench.h), always in
+// benchmark mode: every benchmark runs warmup repetitions, then timed ones, and reports
+// min/median/p95/max/mean of the per-repetition values. Results are written as JSON and can be
+// compared against a baseline run.
+//
+// Timing is wall-clock around glFinish, so numbers are comparable across drivers that differ in
+// timer query support (llvmpipe included).
+//
+// Usage: rcompute_bench [--size MB] [--runs N] [--warmup N] [--quick] [--results path]
+//                       [--baseline path] [--threshold percent]
+
+#define RCOMPUTE_IMPLEMENTATION
+#include "include/rcompute.h"
+#include "example_bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct bench_config
+{
+    GLsizeiptr size;   // bytes moved by transfer and bandwidth benchmarks
+};
+
+// Runs op warmup + runs times. op returns the value for one repetition, or a negative number
+// when the path is unavailable.
+template <typename Op>
+static void run(const char *name, const char *unit, Op op)
+{
+    double *values = new double[bench.runs];
+    int count = 0;
+    for (int i = 0; i < bench.warmup + bench.runs; i++)
+    {
+        double v = op();
+        if (v < 0.0)
+        {
+            count = 0;
+            break;
+        }
+        if (i >= bench.warmup)
+            values[count++] = v;
+    }
+    bench_record(name, unit, values, count, strcmp(unit, "GB/s") == 0);
+    delete[] values;
+}
+
+static double gb_per_s(double bytes, double ms)
+{
+    return ms > 0.0 ? bytes / (ms * 1e6) : 0.0;
+}
+
+// ---------------------------------
+// Kernels
+// ---------------------------------
+static const char *empty_src = R"(
+#version 430
+layout(local_size_x = 1) in;
+void main() {}
+)";
+
+// vec4 streaming kernels; rcompute_group_offset lets rcompute split very large sizes
+static const char *copy_src = R"(
+#version 430
+layout(local_size_x = 256) in;
+layout(std430, binding = 0) readonly buffer Src { vec4 src[]; };
+layout(std430, binding = 1) writeonly buffer Dst { vec4 dst[]; };
+uniform uvec3 rcompute_group_offset;
+void main() {
+    uint i = gl_GlobalInvocationID.x + rcompute_group_offset.x * gl_WorkGroupSize.x;
+    if (i < uint(src.length()))
+        dst[i] = src[i];
+}
+)";
+
+static const char *read_src = R"(
+#version 430
+layout(local_size_x = 256) in;
+layout(std430, binding = 0) readonly buffer Src { vec4 src[]; };
+layout(std430, binding = 1) writeonly buffer Dst { vec4 dst[]; };
+uniform uvec3 rcompute_group_offset;
+void main() {
+    uint i = gl_GlobalInvocationID.x + rcompute_group_offset.x * gl_WorkGroupSize.x;
+    // the store never happens for finite data, but keeps the load alive
+    if (i < uint(src.length()) && src[i].x == -1.0e30)
+        dst[0] = src[i];
+}
+)";
+
+static const char *write_src = R"(
+#version 430
+layout(local_size_x = 256) in;
+layout(std430, binding = 1) writeonly buffer Dst { vec4 dst[]; };
+uniform uvec3 rcompute_group_offset;
+void main() {
+    uint i = gl_GlobalInvocationID.x + rcompute_group_offset.x * gl_WorkGroupSize.x;
+    if (i < uint(dst.length()))
+        dst[i] = vec4(float(i));
+}
+)";
+
+// ---------------------------------
+static void bench_uploads(const bench_config &cfg, unsigned char *host)
+{
+    GLuint buf = rcompute_buffer(cfg.size, NULL);
+
+    run("upload_subdata", "GB/s", [&]() {
+        double t0 = bench_now_ms();
+        rcompute_buffer_write(buf, 0, cfg.size, host);
+        glFinish();
+        return gb_per_s((double)cfg.size, bench_now_ms() - t0);
+    });
+
+    run("upload_map", "GB/s", [&]() {
+        double t0 = bench_now_ms();
+        void *ptr = rcompute_buffer_map(buf, GL_WRITE_ONLY);
+        if (!ptr)
+            return -1.0;
+        memcpy(ptr, host, cfg.size);
+        rcompute_buffer_unmap(buf);
+        glFinish();
+        return gb_per_s((double)cfg.size, bench_now_ms() - t0);
+    });
+
+    // persistent mapping: stream through a ring one segment at a time, copied into buf on the GPU
+    rcompute_ring ring;
+    int have_ring = rcompute_ring_create(&ring, cfg.size, 1);
+    run("upload_persistent", "GB/s", [&]() {
+        if (!have_ring)
+            return -1.0;
+        GLsizeiptr chunk = cfg.size / RCOMPUTE_RING_SEGMENTS;
+        double t0 = bench_now_ms();
+        for (GLsizeiptr done = 0; done < cfg.size; done += chunk)
+        {
+            GLsizeiptr n = cfg.size - done < chunk ? cfg.size - done : chunk;
+            GLsizeiptr offset;
+            void *ptr = rcompute_ring_alloc(&ring, n, 16, &offset);
+            if (!ptr)
+                return -1.0;
+            memcpy(ptr, host + done, n);
+            rcompute_ring_copy(&ring, offset, buf, done, n);
+        }
+        rcompute_ring_fence(&ring);
+        glFinish();
+        return gb_per_s((double)cfg.size, bench_now_ms() - t0);
+    });
+    if (have_ring)
+        rcompute_ring_destroy(&ring);
+
+    rcompute_buffer_destroy(buf);
+}
+
+// ---------------------------------
+static void bench_readbacks(const bench_config &cfg, unsigned char *host)
+{
+    GLuint buf = rcompute_buffer(cfg.size, host);
+
+    run("readback_sync", "GB/s", [&]() {
+        glFinish();
+        double t0 = bench_now_ms();
+        rcompute_read(buf, host, cfg.size);
+        return gb_per_s((double)cfg.size, bench_now_ms() - t0);
+    });
+
+    run("readback_async", "GB/s", [&]() {
+        glFinish();
+        double t0 = bench_now_ms();
+        rcompute_ticket ticket = rcompute_readback(buf, 0, cfg.size);
+        if (!ticket || !rcompute_readback_wait(ticket, host))
+            return -1.0;
+        return gb_per_s((double)cfg.size, bench_now_ms() - t0);
+    });
+
+    rcompute_buffer_destroy(buf);
+}
+
+// ---------------------------------
+static void bench_dispatch(rcompute *c)
+{
+    const int batch = 256;
+    GLuint program = rcompute_compile(empty_src);
+    rcompute_set_program(c, program);
+
+    // one dispatch, submitted and waited for
+    run("dispatch_latency", "us", [&]() {
+        glFinish();
+        double t0 = bench_now_ms();
+        rcompute_run(c, 1, 1, 1);
+        glFinish();
+        return (bench_now_ms() - t0) * 1000.0;
+    });
+
+    // back-to-back dispatches: per-dispatch submission and execution cost
+    run("dispatch_throughput", "us", [&]() {
+        glFinish();
+        double t0 = bench_now_ms();
+        for (int i = 0; i < batch; i++)
+            rcompute_run(c, 1, 1, 1);
+        glFinish();
+        return (bench_now_ms() - t0) * 1000.0 / batch;
+    });
+
+    // same batch with a full barrier between dispatches; the difference is the barrier
+    run("barrier_cost", "us", [&]() {
+        glFinish();
+        double t0 = bench_now_ms();
+        for (int i = 0; i < batch; i++)
+            rcompute_run(c, 1, 1, 1);
+        glFinish();
+        double plain = bench_now_ms() - t0;
+
+        t0 = bench_now_ms();
+        for (int i = 0; i < batch; i++)
+        {
+            rcompute_run(c, 1, 1, 1);
+            rcompute_barrier_all();
+        }
+        glFinish();
+        double with_barriers = bench_now_ms() - t0;
+        double cost = (with_barriers - plain) * 1000.0 / batch;
+        return cost > 0.0 ? cost : 0.0;
+    });
+
+    rcompute_set_program(c, 0);
+    rcompute_program_destroy(program);
+}
+
+// ---------------------------------
+static void bench_compile()
+{
+    // a comment unique to this run and repetition defeats driver and program-binary caches
+    long long nonce = (long long)(bench_now_ms() * 1000.0);
+    int serial = 0;
+    char src[1024];
+    run("compile", "ms", [&]() {
+        snprintf(src, sizeof(src), "%s// rcompute_bench %lld.%d\n", copy_src, nonce, serial++);
+        double t0 = bench_now_ms();
+        GLuint program = rcompute_compile(src);
+        double elapsed = bench_now_ms() - t0;
+        if (!program)
+            return -1.0;
+        rcompute_program_destroy(program);
+        return elapsed;
+    });
+}
+
+// ---------------------------------
+static void bench_bandwidth(const bench_config &cfg, rcompute *c)
+{
+    int elements = (int)(cfg.size / 16);
+    GLuint src = rcompute_buffer_zero(cfg.size);
+    GLuint dst = rcompute_buffer_zero(cfg.size);
+    rcompute_buffer_bind(src, 0);
+    rcompute_buffer_bind(dst, 1);
+
+    struct
+    {
+        const char *name;
+        const char *source;
+        double bytes; // moved per dispatch
+    } kernels[] = {
+        {"ssbo_copy", copy_src, 2.0 * cfg.size},
+        {"ssbo_read", read_src, (double)cfg.size},
+        {"ssbo_write", write_src, (double)cfg.size},
+    };
+
+    for (auto &k : kernels)
+    {
+        GLuint program = rcompute_compile(k.source);
+        rcompute_set_program(c, program);
+        run(k.name, "GB/s", [&]() {
+            if (!program)
+                return -1.0;
+            glFinish();
+            double t0 = bench_now_ms();
+            rcompute_dispatch_items_1d(c, elements);
+            glFinish();
+            return gb_per_s(k.bytes, bench_now_ms() - t0);
+        });
+        rcompute_set_program(c, 0);
+        rcompute_program_destroy(program);
+    }
+
+    rcompute_buffer_destroy(src);
+    rcompute_buffer_destroy(dst);
+}
+
+// ---------------------------------
+int main(int argc, char **argv)
+{
+    if (!bench_init(argc, argv, "rcompute_bench", 1))
+        return 1;
+    // --size is in MB here; --quick also shrinks the default to 4 MB
+    bench_config cfg = {(GLsizeiptr)bench_size(bench.quick ? 4 : 32) << 20};
+    if (cfg.size < (1 << 20))
+    {
+        fprintf(stderr, "Size must be at least 1 MB\n");
+        return 1;
+    }
+
+    rcompute ctx;
+    if (!rcompute_init(&ctx, 4, 3))
+    {
+        fprintf(stderr, "Init failed: %s\n", rcompute_get_last_error());
+        return 1;
+    }
+
+    printf("=== rcompute_bench ===\n");
+    printf("Device: %s (%s)\nOpenGL: %s\n", (const char *)glGetString(GL_RENDERER),
+           (const char *)glGetString(GL_VENDOR), (const char *)glGetString(GL_VERSION));
+    printf("Size: %lld MB, %d warmup + %d timed repetitions\n", (long long)(cfg.size >> 20), bench.warmup, bench.runs);
+
+    unsigned char *host = new unsigned char[cfg.size];
+    for (GLsizeiptr i = 0; i < cfg.size; i++)
+        host[i] = (unsigned char)(i * 31);
+
+    bench_uploads(cfg, host);
+    bench_readbacks(cfg, host);
+    bench_dispatch(&ctx);
+    bench_compile();
+    bench_bandwidth(cfg, &ctx);
+
+    delete[] host;
+    rcompute_destroy(&ctx);
+    return bench_finish();
+}